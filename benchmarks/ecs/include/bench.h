@@ -0,0 +1,119 @@
+// Copyright © 2024 Jacob Curlin
+
+// Minimal timing helpers shared by the ecs benchmarks, & the setup their worlds share.
+
+#pragma once
+
+#include "core/job_system.h"
+#include "ecs/ecs_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cgx::bench
+{
+struct Result
+{
+    std::string name;
+    std::size_t entity_count{0};
+    double      ns_per_entity{0.0};
+};
+
+// Runs 'setup' then 'func' 'iterations' times after one warm-up round & returns the fastest 'func' run's time
+// per entity ('setup' isn't timed).
+template<typename Setup, typename Func>
+Result measure_with_setup(const std::string& name, const std::size_t entity_count, const int iterations, Setup&& setup,
+                          Func&&             func)
+{
+    using clock = std::chrono::steady_clock;
+
+    setup();
+    func();
+
+    double best_ns = std::numeric_limits<double>::max();
+    for (int i = 0 ; i < iterations ; ++i) {
+        setup();
+        const auto start = clock::now();
+        func();
+        const auto end = clock::now();
+        best_ns = std::min(best_ns, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    return {name, entity_count, best_ns / static_cast<double>(std::max<std::size_t>(entity_count, 1))};
+}
+
+template<typename Func>
+Result measure(const std::string& name, const std::size_t entity_count, const int iterations, Func&& func)
+{
+    return measure_with_setup(name, entity_count, iterations, [] {}, std::forward<Func>(func));
+}
+
+// keeps a benchmark's result from being optimized away: the compiler must assume the value's memory is read
+template<typename T>
+void do_not_optimize(const T& value)
+{
+#if defined(_MSC_VER)
+    const void* volatile address = &value;
+    static_cast<void>(address);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+inline void print_result(const Result& result)
+{
+    std::fprintf(stderr, "%-40s %8zu entities %10.2f ns/entity\n", result.name.c_str(), result.entity_count, result.ns_per_entity);
+}
+
+// one object per result, for tracking across commits (names are plain identifiers; no escaping needed)
+inline void write_json(const std::vector<Result>& results, std::FILE* file)
+{
+    std::fprintf(file, "{\n  \"benchmarks\": [");
+    for (std::size_t i = 0 ; i < results.size() ; ++i) {
+        std::fprintf(file, "%s\n    {\"name\": \"%s\", \"entities\": %zu, \"ns_per_entity\": %.3f}", i == 0 ? "" : ",",
+                     results[i].name.c_str(), results[i].entity_count, results[i].ns_per_entity);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+}
+
+// the job system shared by every world of the executable (no workers: jobs run on the thread waiting for them)
+inline core::JobSystem& get_job_system()
+{
+    static core::JobSystem job_system(0);
+    return job_system;
+}
+
+inline std::unique_ptr<ecs::ECSManager> make_ecs_manager()
+{
+    return std::make_unique<ecs::ECSManager>(&get_job_system());
+}
+
+// Registers system S over the entities holding every one of 'Components' (registered before).
+template<typename S, typename... Components>
+std::shared_ptr<S> register_system(ecs::ECSManager& ecs_manager)
+{
+    const auto     system = ecs_manager.register_system<S>();
+    ecs::Signature signature;
+    (signature.set(ecs_manager.get_component_type<Components>()), ...);
+    ecs_manager.set_system_signature<S>(signature);
+    return system;
+}
+
+void run_registry_benchmarks(std::vector<Result>& results);
+void run_event_benchmarks(std::vector<Result>& results);
+void run_hierarchy_benchmarks(std::vector<Result>& results);
+void run_transform_benchmarks(std::vector<Result>& results);
+void run_view_benchmarks(std::vector<Result>& results);
+void run_job_system_benchmarks(std::vector<Result>& results);
+void run_physics_benchmarks(std::vector<Result>& results);
+void run_snapshot_benchmarks(std::vector<Result>& results);
+}
@@ -0,0 +1,175 @@
+// Copyright © 2024 Jacob Curlin
+
+// Compares event dispatch through the original per-id std::list of listeners against the flat listener lists
+// (EventId-keyed & typed), measures the coalescing of a scene import's parent updates, & stresses
+// multi-producer posting: 1 - 8 threads post events while the main thread flushes them.
+
+#include "bench.h"
+
+#include "core/event_handler.h"
+#include "core/events/ecs_events.h"
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace cgx::bench
+{
+namespace
+{
+using core::event::operator""_hash;
+
+constexpr std::size_t          k_listener_count = 8;
+constexpr std::size_t          k_dispatch_count = 100'000;
+constexpr std::size_t          k_node_count     = 10'000;
+constexpr core::event::EventId k_bench_event    = "event::bench::DISPATCH"_hash;
+
+struct DispatchEvent
+{
+    std::uint32_t value;
+};
+
+// the listener storage events used before subscriptions
+class ListEventHandler
+{
+public:
+    void add_listener(const core::event::EventId event_id, const std::function<void(core::event::Event&)>& listener)
+    {
+        m_listeners[event_id].push_back(listener);
+    }
+
+    void send_event(core::event::Event& event)
+    {
+        for (auto const& listener : m_listeners[event.get_type()]) {
+            listener(event);
+        }
+    }
+
+private:
+    std::unordered_map<core::event::EventId, std::list<std::function<void(core::event::Event&)>>> m_listeners;
+};
+
+void run_dispatch_benchmarks(std::vector<Result>& results)
+{
+    std::uint64_t sum = 0;
+
+    ListEventHandler list_handler;
+    for (std::size_t i = 0 ; i < k_listener_count ; ++i) {
+        list_handler.add_listener(k_bench_event, [&sum](core::event::Event& event) { sum += event.get_type(); });
+    }
+    results.push_back(
+        measure("event/dispatch/list_by_id", k_dispatch_count, 10, [&] {
+            core::event::Event event(k_bench_event);
+            for (std::size_t i = 0 ; i < k_dispatch_count ; ++i) {
+                list_handler.send_event(event);
+            }
+        }));
+
+    auto&                           event_handler = core::EventHandler::get_instance();
+    std::vector<core::Subscription> subscriptions;
+    for (std::size_t i = 0 ; i < k_listener_count ; ++i) {
+        subscriptions.push_back(
+            event_handler.add_listener(k_bench_event, [&sum](core::event::Event& event) { sum += event.get_type(); }));
+        subscriptions.push_back(
+            event_handler.add_listener<DispatchEvent>([&sum](const DispatchEvent& event) { sum += event.value; }));
+    }
+    results.push_back(
+        measure("event/dispatch/flat_by_id", k_dispatch_count, 10, [&] {
+            core::event::Event event(k_bench_event);
+            for (std::size_t i = 0 ; i < k_dispatch_count ; ++i) {
+                event_handler.send_event(event);
+            }
+        }));
+    results.push_back(
+        measure("event/dispatch/flat_typed", k_dispatch_count, 10, [&] {
+            for (std::size_t i = 0 ; i < k_dispatch_count ; ++i) {
+                event_handler.send(DispatchEvent{static_cast<std::uint32_t>(i)});
+            }
+        }));
+
+    do_not_optimize(sum);
+}
+
+// A scene import reparents each node a few times (attached to the scene root, then moved under its parent);
+// the parent updates of a frame are delivered as one update per node.
+void run_coalescing_benchmarks(std::vector<Result>& results)
+{
+    using core::event::component::hierarchy::ParentUpdated;
+
+    auto&       event_handler = core::EventHandler::get_instance();
+    std::size_t delivered     = 0;
+    const auto  subscription  = event_handler.add_batch_listener<ParentUpdated>(
+        [&delivered](const std::span<const ParentUpdated> events) { delivered += events.size(); });
+
+    constexpr std::size_t k_updates_per_node = 4;
+    const auto            phase              = event_handler.get_channel<ParentUpdated>().get_phase();
+    results.push_back(
+        measure("event/coalesce/parent_updates", k_node_count * k_updates_per_node, 10, [&] {
+            for (std::size_t update = 0 ; update < k_updates_per_node ; ++update) {
+                for (std::size_t node = 0 ; node < k_node_count ; ++node) {
+                    const auto child = static_cast<ecs::Entity>(node + 1);
+                    event_handler.enqueue(ParentUpdated{child, static_cast<ecs::Entity>(update),
+                                                        static_cast<ecs::Entity>(update + 1)});
+                }
+            }
+            event_handler.flush(phase);
+        }));
+    do_not_optimize(delivered);
+}
+
+struct StressEvent
+{
+    std::uint32_t producer;
+    std::uint32_t sequence;
+};
+
+void post_from_threads(core::EventHandler& event_handler, std::size_t& received, const std::size_t producer_count,
+                       const std::size_t event_count)
+{
+    received = 0;
+
+    std::atomic<bool>        start{false};
+    std::vector<std::thread> producers;
+    for (std::size_t producer = 0 ; producer < producer_count ; ++producer) {
+        producers.emplace_back([&, producer] {
+            while (!start.load(std::memory_order_acquire)) {}
+            for (std::size_t i = 0 ; i < event_count / producer_count ; ++i) {
+                event_handler.post(StressEvent{static_cast<std::uint32_t>(producer), static_cast<std::uint32_t>(i)});
+            }
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    const std::size_t expected = event_count / producer_count * producer_count;
+    while (received < expected) {
+        event_handler.flush(core::EventPhase::PreUpdate);
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+}
+
+void run_event_benchmarks(std::vector<Result>& results)
+{
+    run_dispatch_benchmarks(results);
+    run_coalescing_benchmarks(results);
+
+    auto&       event_handler = core::EventHandler::get_instance();
+    std::size_t received      = 0;
+    const auto  subscription  = event_handler.add_listener<StressEvent>([&received](const StressEvent&) { ++received; });
+
+    constexpr std::size_t event_count = 400'000;
+    for (const std::size_t producer_count : {1u, 2u, 4u, 8u}) {
+        results.push_back(
+            measure("event/post_flush/producers=" + std::to_string(producer_count), event_count, 5, [&] {
+                post_from_threads(event_handler, received, producer_count, event_count);
+            }));
+    }
+}
+}
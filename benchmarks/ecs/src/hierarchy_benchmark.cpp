@@ -0,0 +1,168 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures the hierarchy system's traversal order maintenance over a 100k-node tree: building it node by node
+// (spliced in incrementally, or inside a batch rebuilt once), reparenting leaves between subtrees & releasing
+// leaves (tombstoned, then compacted by the next 'get_order'). Incremental builds add nodes depth-first, as
+// importers walk their scene graphs (each new node then ends its parent's subtree), or breadth-first: each node
+// then splices into the middle of the order, shifting everything after it (O(N) per node, so that build runs
+// over a 10k-node tree).
+
+#include "bench.h"
+
+#include "core/systems/hierarchy_system.h"
+#include "ecs/ecs_manager.h"
+#include "core/components/hierarchy.h"
+#include "core/components/transform.h"
+
+#include <memory>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr int         k_iterations   = 5;
+constexpr std::size_t k_node_count   = 100'000;
+constexpr std::size_t k_small_count  = 10'000; // (quadratic builds)
+constexpr std::size_t k_branching    = 8; // children per node
+constexpr std::size_t k_change_count = 1'000;
+
+struct World
+{
+    std::unique_ptr<ecs::ECSManager>       ecs_manager;
+    std::shared_ptr<core::HierarchySystem> hierarchy_system;
+    std::vector<ecs::Entity>               nodes;
+    std::vector<component::Hierarchy>      hierarchies; // (indexed by node; children of n are n * k + 1 ... n * k + k)
+    std::vector<std::size_t>               depth_first; // nodes in depth-first order
+};
+
+// acquires the tree's entities & prepares their hierarchy components without adding them
+World make_world(const std::size_t node_count = k_node_count)
+{
+    World world;
+    world.ecs_manager = make_ecs_manager();
+    world.ecs_manager->register_component<component::Hierarchy>();
+    world.ecs_manager->register_component<component::Transform>();
+
+    world.hierarchy_system = register_system<core::HierarchySystem, component::Hierarchy>(*world.ecs_manager);
+
+    world.nodes = world.ecs_manager->acquire_entities(node_count);
+    world.hierarchies.resize(node_count);
+    for (std::size_t node = 1 ; node < node_count ; ++node) {
+        const std::size_t parent       = (node - 1) / k_branching;
+        world.hierarchies[node].parent = world.nodes[parent];
+        world.hierarchies[parent].children.push_back(world.nodes[node]);
+    }
+
+    std::vector<std::size_t> stack = {0};
+    while (!stack.empty()) {
+        const std::size_t node = stack.back();
+        stack.pop_back();
+        world.depth_first.push_back(node);
+        for (std::size_t child = node * k_branching + k_branching ; child > node * k_branching ; --child) {
+            if (child < node_count) { // (pushed last to first, so children are visited in order)
+                stack.push_back(child);
+            }
+        }
+    }
+    return world;
+}
+
+void add_depth_first(World& world)
+{
+    for (const auto node : world.depth_first) {
+        world.ecs_manager->add_component(world.nodes[node], world.hierarchies[node]);
+    }
+}
+
+void add_breadth_first(World& world)
+{
+    for (std::size_t node = 0 ; node < world.nodes.size() ; ++node) {
+        world.ecs_manager->add_component(world.nodes[node], world.hierarchies[node]);
+    }
+}
+
+World make_tree()
+{
+    World world = make_world();
+    add_depth_first(world);
+    return world;
+}
+}
+
+void run_hierarchy_benchmarks(std::vector<Result>& results)
+{
+    {
+        World world;
+        results.push_back(
+            measure_with_setup("hierarchy/build/incremental", k_node_count, k_iterations,
+                [&] { world = make_world(); },
+                [&] {
+                    add_depth_first(world);
+                    do_not_optimize(world.hierarchy_system->get_order().size());
+                }));
+
+        results.push_back(
+            measure_with_setup("hierarchy/build/incremental_breadth_first", k_small_count, k_iterations,
+                [&] { world = make_world(k_small_count); },
+                [&] {
+                    add_breadth_first(world);
+                    do_not_optimize(world.hierarchy_system->get_order().size());
+                }));
+
+        results.push_back(
+            measure_with_setup("hierarchy/build/batched", k_node_count, k_iterations,
+                [&] { world = make_world(); },
+                [&] {
+                    world.hierarchy_system->begin_batch();
+                    add_depth_first(world);
+                    world.hierarchy_system->end_batch();
+                    do_not_optimize(world.hierarchy_system->get_order().size());
+                }));
+
+        results.push_back(
+            measure_with_setup("hierarchy/build/batched_breadth_first", k_node_count, k_iterations,
+                [&] { world = make_world(); },
+                [&] {
+                    world.hierarchy_system->begin_batch();
+                    add_breadth_first(world);
+                    world.hierarchy_system->end_batch();
+                    do_not_optimize(world.hierarchy_system->get_order().size());
+                }));
+    }
+
+    {
+        // moves the tree's last leaves back & forth between the first & last internal nodes
+        World                    world   = make_tree();
+        const ecs::Entity        first   = world.nodes[1];
+        const ecs::Entity        last    = world.nodes[(k_node_count - 2) / k_branching];
+        std::vector<ecs::Entity> parents = {};
+        for (std::size_t node = k_node_count - k_change_count ; node < k_node_count ; ++node) {
+            parents.push_back(world.hierarchies[node].parent);
+        }
+
+        results.push_back(
+            measure("hierarchy/reparent", k_change_count, k_iterations, [&] {
+                for (std::size_t i = 0 ; i < k_change_count ; ++i) {
+                    const ecs::Entity child      = world.nodes[k_node_count - k_change_count + i];
+                    const ecs::Entity new_parent = parents[i] == first ? last : first;
+                    world.hierarchy_system->on_parent_update(child, parents[i], new_parent);
+                    parents[i] = new_parent;
+                }
+                do_not_optimize(world.hierarchy_system->get_order().size());
+            }));
+    }
+
+    {
+        World world;
+        results.push_back(
+            measure_with_setup("hierarchy/release_leaves", k_change_count, k_iterations,
+                [&] { world = make_tree(); },
+                [&] {
+                    for (std::size_t node = k_node_count - k_change_count ; node < k_node_count ; ++node) {
+                        world.ecs_manager->release_entity(world.nodes[node]);
+                    }
+                    do_not_optimize(world.hierarchy_system->get_order().size());
+                }));
+    }
+}
+}
@@ -0,0 +1,80 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures job system scheduling overhead (empty jobs, fine-grained parallel_for) & the scaling of a
+// compute-bound parallel_for from one thread up to every hardware thread.
+
+#include "bench.h"
+
+#include "core/job_system.h"
+
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace cgx::bench
+{
+namespace
+{
+// 1, 2, 4, ... up to (& including) the hardware thread count
+std::vector<std::size_t> get_thread_counts()
+{
+    const std::size_t hardware_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t count = 1 ; count < hardware_threads ; count *= 2) {
+        thread_counts.push_back(count);
+    }
+    thread_counts.push_back(hardware_threads);
+    return thread_counts;
+}
+
+float compute(const float value)
+{
+    float result = value;
+    for (int i = 0 ; i < 32 ; ++i) {
+        result = std::sqrt(result * result + 1.0f) * 0.5f;
+    }
+    return result;
+}
+}
+
+void run_job_system_benchmarks(std::vector<Result>& results)
+{
+    constexpr std::size_t job_count     = 10'000;
+    constexpr std::size_t element_count = 1'000'000;
+
+    std::vector<float> values(element_count, 1.0f);
+
+    for (const std::size_t thread_count : get_thread_counts()) {
+        core::JobSystem   job_system(thread_count - 1);
+        const std::string suffix = "/threads=" + std::to_string(thread_count);
+
+        results.push_back(
+            measure("jobs/submit_wait_empty" + suffix, job_count, 20, [&] {
+                core::JobCounter counter;
+                for (std::size_t i = 0 ; i < job_count ; ++i) {
+                    job_system.submit([] {}, &counter);
+                }
+                job_system.wait(counter);
+            }));
+
+        results.push_back(
+            measure("jobs/parallel_for_grain_64" + suffix, element_count, 20, [&] {
+                job_system.parallel_for(0, element_count, 64, [&](const std::size_t begin, const std::size_t end) {
+                    for (std::size_t i = begin ; i < end ; ++i) {
+                        values[i] += 1.0f;
+                    }
+                });
+            }));
+
+        results.push_back(
+            measure("jobs/parallel_for_compute" + suffix, element_count, 10, [&] {
+                job_system.parallel_for(0, element_count, 4096, [&](const std::size_t begin, const std::size_t end) {
+                    for (std::size_t i = begin ; i < end ; ++i) {
+                        values[i] = compute(values[i]);
+                    }
+                });
+            }));
+    }
+}
+}
@@ -0,0 +1,26 @@
+// Copyright © 2024 Jacob Curlin
+
+// Runs every ecs benchmark; writes the results as JSON to stdout & as a readable table to stderr.
+
+#include "bench.h"
+
+int main()
+{
+    std::vector<cgx::bench::Result> results;
+
+    cgx::bench::run_registry_benchmarks(results);
+    cgx::bench::run_view_benchmarks(results);
+    cgx::bench::run_job_system_benchmarks(results);
+    cgx::bench::run_physics_benchmarks(results);
+    cgx::bench::run_event_benchmarks(results);
+    cgx::bench::run_hierarchy_benchmarks(results);
+    cgx::bench::run_transform_benchmarks(results);
+    cgx::bench::run_snapshot_benchmarks(results);
+
+    for (const auto& result : results) {
+        cgx::bench::print_result(result);
+    }
+    cgx::bench::write_json(results, stdout);
+
+    return 0;
+}
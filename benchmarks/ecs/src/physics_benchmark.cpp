@@ -0,0 +1,60 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures the physics integration step (PhysicsSystem::fixed_update over the transform / rigid body group)
+// against body count, at 1, 2, 4 & 8 threads.
+
+#include "bench.h"
+
+#include "core/job_system.h"
+#include "ecs/ecs_manager.h"
+#include "physics/physics_system.h"
+#include "core/components/transform.h"
+#include "core/components/rigid_body.h"
+
+#include <memory>
+#include <string>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr float k_fixed_dt = 1.0f / 60.0f;
+
+std::unique_ptr<ecs::ECSManager> make_world(core::JobSystem& job_system, const std::size_t body_count)
+{
+    auto ecs_manager = std::make_unique<ecs::ECSManager>(&job_system);
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::RigidBody>();
+    ecs_manager->register_group<component::Transform, component::RigidBody>();
+
+    ecs_manager->register_system<physics::PhysicsSystem>();
+    ecs::Signature signature;
+    signature.set(ecs_manager->get_component_type<component::Transform>());
+    signature.set(ecs_manager->get_component_type<component::RigidBody>());
+    ecs_manager->set_system_signature<physics::PhysicsSystem>(signature);
+    ecs_manager->set_system_access<physics::PhysicsSystem>({}, signature);
+
+    component::RigidBody rigid_body{};
+    rigid_body.velocity     = glm::vec3(1.0f, 0.0f, 0.0f);
+    rigid_body.acceleration = glm::vec3(0.0f, -9.8f, 0.0f);
+
+    const auto bodies = ecs_manager->acquire_entities(body_count);
+    ecs_manager->add_components(bodies, component::Transform{}, rigid_body);
+
+    return ecs_manager;
+}
+}
+
+void run_physics_benchmarks(std::vector<Result>& results)
+{
+    for (const std::size_t thread_count : {1u, 2u, 4u, 8u}) {
+        core::JobSystem   job_system(thread_count - 1);
+        const std::string name = "physics/step/threads=" + std::to_string(thread_count);
+
+        for (const std::size_t body_count : {1'000u, 10'000u, 50'000u, 100'000u}) {
+            const auto world = make_world(job_system, body_count);
+            results.push_back(measure(name, body_count, 20, [&] { world->fixed_update(k_fixed_dt); }));
+        }
+    }
+}
+}
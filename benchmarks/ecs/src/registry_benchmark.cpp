@@ -0,0 +1,177 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures the ecs manager's basic operations: entity acquire / release churn, per-component add / remove /
+// get / has, system membership updates, multi-component iteration & the destruction of populated entities
+// (one by one & batched).
+
+#include "bench.h"
+
+#include "ecs/ecs_manager.h"
+#include "ecs/system.h"
+#include "core/components/collider.h"
+#include "core/components/rigid_body.h"
+#include "core/components/transform.h"
+
+#include <memory>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr int k_iterations = 10;
+
+// matches every entity holding a transform & a rigid body; only its membership is measured
+class MembershipSystem final : public ecs::System
+{
+public:
+    explicit MembershipSystem(ecs::ECSManager* ecs_manager)
+        : System(ecs_manager) {}
+
+    void frame_update(float dt) override {}
+    void fixed_update(float dt) override {}
+    void on_entity_added(ecs::Entity entity) override {}
+    void on_entity_removed(ecs::Entity entity) override {}
+};
+
+std::unique_ptr<ecs::ECSManager> make_world()
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::RigidBody>();
+    ecs_manager->register_component<component::Collider>();
+
+    register_system<MembershipSystem, component::Transform, component::RigidBody>(*ecs_manager);
+
+    return ecs_manager;
+}
+
+// entities holding a transform each
+std::vector<ecs::Entity> populate(ecs::ECSManager& ecs_manager, const std::size_t entity_count)
+{
+    auto entities = ecs_manager.acquire_entities(entity_count);
+    ecs_manager.add_components(entities, component::Transform{});
+    return entities;
+}
+
+void run_at_entity_count(std::vector<Result>& results, const std::size_t entity_count)
+{
+    {
+        const auto world = make_world();
+        results.push_back(
+            measure("registry/entity_acquire_release", entity_count, k_iterations, [&] {
+                const auto entities = world->acquire_entities(entity_count);
+                for (const auto entity : entities) {
+                    world->release_entity(entity);
+                }
+            }));
+    }
+
+    {
+        const auto world    = make_world();
+        const auto entities = populate(*world, entity_count);
+
+        // (colliders aren't part of any system signature)
+        results.push_back(
+            measure("registry/component_add_remove", entity_count, k_iterations, [&] {
+                for (const auto entity : entities) {
+                    world->add_component(entity, component::Collider{});
+                }
+                for (const auto entity : entities) {
+                    world->remove_component<component::Collider>(entity);
+                }
+            }));
+
+        results.push_back(
+            measure("registry/component_get", entity_count, k_iterations, [&] {
+                float sum = 0.0f;
+                for (const auto entity : entities) {
+                    sum += world->get_component<component::Transform>(entity).scale.x;
+                }
+                do_not_optimize(sum);
+            }));
+
+        results.push_back(
+            measure("registry/component_has", entity_count, k_iterations, [&] {
+                std::size_t count = 0;
+                for (const auto entity : entities) {
+                    count += world->has_component<component::Transform>(entity);
+                }
+                do_not_optimize(count);
+            }));
+
+        // each rigid body added / removed moves the entity into / out of the system's entity set
+        results.push_back(
+            measure("registry/system_membership_update", entity_count, k_iterations, [&] {
+                for (const auto entity : entities) {
+                    world->add_component(entity, component::RigidBody{});
+                }
+                for (const auto entity : entities) {
+                    world->remove_component<component::RigidBody>(entity);
+                }
+            }));
+    }
+
+    {
+        // every entity holds a transform, every other one a rigid body, every fourth one a collider too
+        const auto world    = make_world();
+        const auto entities = populate(*world, entity_count);
+        for (std::size_t i = 0 ; i < entities.size() ; i += 2) {
+            world->add_component(entities[i], component::RigidBody{});
+            if (i % 4 == 0) {
+                world->add_component(entities[i], component::Collider{});
+            }
+        }
+
+        results.push_back(
+            measure("registry/view_2_components", entity_count / 2, k_iterations, [&] {
+                world->view<component::Transform, component::RigidBody>().each(
+                    [](ecs::Entity, component::Transform& transform, const component::RigidBody& rigid_body) {
+                        transform.translation += rigid_body.velocity;
+                    });
+            }));
+
+        results.push_back(
+            measure("registry/view_3_components", entity_count / 4, k_iterations, [&] {
+                world->view<component::Transform, component::RigidBody, component::Collider>().each(
+                    [](ecs::Entity, component::Transform& transform, const component::RigidBody& rigid_body,
+                       const component::Collider& collider) {
+                        transform.translation += rigid_body.velocity * collider.size;
+                    });
+            }));
+    }
+
+    {
+        const auto               world = make_world();
+        std::vector<ecs::Entity> entities;
+        results.push_back(
+            measure_with_setup("registry/entity_destroy_populated", entity_count, k_iterations,
+                [&] {
+                    entities = world->acquire_entities(entity_count);
+                    world->add_components(entities, component::Transform{}, component::RigidBody{},
+                                          component::Collider{});
+                },
+                [&] {
+                    for (const auto entity : entities) {
+                        world->release_entity(entity);
+                    }
+                }));
+
+        results.push_back(
+            measure_with_setup("registry/entity_destroy_batch", entity_count, k_iterations,
+                [&] {
+                    entities = world->acquire_entities(entity_count);
+                    world->add_components(entities, component::Transform{}, component::RigidBody{},
+                                          component::Collider{});
+                },
+                [&] { world->release_entities(entities); }));
+    }
+}
+}
+
+void run_registry_benchmarks(std::vector<Result>& results)
+{
+    for (const std::size_t entity_count : {1'000u, 10'000u, 100'000u}) {
+        run_at_entity_count(results, entity_count);
+    }
+}
+}
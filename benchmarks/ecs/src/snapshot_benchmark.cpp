@@ -0,0 +1,93 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures saving a populated world to a snapshot & loading it into a fresh one, per entity (raw pages for
+// trivially copyable components, the hierarchy serializer otherwise; colliders are registered but never added,
+// so their section is empty). Loading raw pages is meant to run at close to memcpy speed, after the loader's
+// pass checking the file.
+
+#include "bench.h"
+
+#include "ecs/ecs_manager.h"
+#include "core/components/collider.h"
+#include "core/components/hierarchy.h"
+#include "core/components/rigid_body.h"
+#include "core/components/transform.h"
+
+#include <filesystem>
+#include <memory>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr int         k_iterations   = 5;
+constexpr std::size_t k_entity_count = 100'000;
+constexpr std::size_t k_branching    = 8; // children per hierarchy node
+
+std::unique_ptr<ecs::ECSManager> make_world()
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::RigidBody>();
+    ecs_manager->register_component<component::Collider>();
+    ecs_manager->register_component<component::Hierarchy>();
+    ecs_manager->set_component_serializer<component::Hierarchy>(component::get_hierarchy_serializer());
+    return ecs_manager;
+}
+
+// Every entity holds a transform, every other one a rigid body & every fourth one a hierarchy node (a tree over
+// those entities). Every tenth entity is released again, so the snapshot holds free slots.
+std::vector<ecs::Entity> populate(ecs::ECSManager& ecs_manager)
+{
+    auto entities = ecs_manager.acquire_entities(k_entity_count);
+    for (std::size_t i = 0 ; i < entities.size() ; ++i) {
+        component::Transform transform;
+        transform.translation = glm::vec3(static_cast<float>(i), 1.0f, 2.0f);
+        ecs_manager.add_component(entities[i], transform);
+
+        if (i % 2 == 0) {
+            component::RigidBody rigid_body{};
+            rigid_body.velocity = glm::vec3(0.0f, static_cast<float>(i), 0.0f);
+            ecs_manager.add_component(entities[i], rigid_body);
+        }
+    }
+
+    std::vector<component::Hierarchy> hierarchies(k_entity_count / 4);
+    for (std::size_t node = 1 ; node < hierarchies.size() ; ++node) {
+        const std::size_t parent       = (node - 1) / k_branching;
+        hierarchies[node].parent       = entities[parent * 4];
+        hierarchies[parent].children.push_back(entities[node * 4]);
+    }
+    for (std::size_t node = 0 ; node < hierarchies.size() ; ++node) {
+        ecs_manager.add_component(entities[node * 4], std::move(hierarchies[node]));
+    }
+
+    for (std::size_t i = 5 ; i < entities.size() ; i += 10) {
+        ecs_manager.release_entity(entities[i]);
+    }
+    return entities;
+}
+}
+
+void run_snapshot_benchmarks(std::vector<Result>& results)
+{
+    const auto path = std::filesystem::temp_directory_path() / "cgx_ecs_bench.snapshot";
+
+    const auto saved = make_world();
+    populate(*saved);
+
+    results.push_back(
+        measure("snapshot/save", k_entity_count, k_iterations, [&] {
+            do_not_optimize(saved->save_snapshot(path));
+        }));
+
+    std::unique_ptr<ecs::ECSManager> loaded;
+    results.push_back(
+        measure_with_setup("snapshot/load", k_entity_count, k_iterations,
+            [&] { loaded = make_world(); },
+            [&] { do_not_optimize(loaded->load_snapshot(path)); }));
+
+    loaded.reset();
+    std::filesystem::remove(path);
+}
+}
@@ -0,0 +1,142 @@
+// Copyright © 2024 Jacob Curlin
+
+// Measures local matrix composition (the former scale / translate / euler rotate matrix products against the
+// quaternion TRS written out by TransformSystem::update_local_matrix) & the transform system's world matrix
+// update over a forest of shallow trees, with every transform changed, only the roots, or none.
+
+#include "bench.h"
+
+#include "core/systems/hierarchy_system.h"
+#include "core/systems/transform_system.h"
+#include "ecs/ecs_manager.h"
+#include "core/components/hierarchy.h"
+#include "core/components/transform.h"
+
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include <memory>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr int         k_iterations     = 10;
+constexpr float       k_fixed_dt       = 1.0f / 60.0f;
+constexpr std::size_t k_children_count = 15; // per root
+
+// the transform's layout before rotations were stored as quaternions
+struct EulerTransform
+{
+    glm::vec3 translation;
+    glm::vec3 rotation; // (degrees)
+    glm::vec3 scale;
+};
+
+glm::mat4 compose_euler(const EulerTransform& transform)
+{
+    auto local_matrix = glm::mat4(1.0f);
+    local_matrix      = glm::scale(local_matrix, transform.scale);
+    local_matrix      = glm::translate(local_matrix, transform.translation);
+    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+    return local_matrix;
+}
+
+// 'root_count' roots with k_children_count children each
+std::unique_ptr<ecs::ECSManager> make_forest(const std::size_t root_count, std::vector<ecs::Entity>& roots,
+                                             std::vector<ecs::Entity>& entities)
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::Hierarchy>();
+
+    const auto hierarchy_system = register_system<core::HierarchySystem, component::Hierarchy>(*ecs_manager);
+    register_system<core::TransformSystem, component::Transform>(*ecs_manager)->set_hierarchy_system(
+        hierarchy_system.get());
+
+    component::Transform transform{};
+    transform.translation = glm::vec3(1.0f, 2.0f, 3.0f);
+    transform.set_euler_angles(glm::vec3(10.0f, 20.0f, 30.0f));
+
+    entities = ecs_manager->acquire_entities(root_count * (k_children_count + 1));
+    ecs_manager->add_components(entities, transform);
+    for (std::size_t root = 0 ; root < root_count ; ++root) {
+        const auto* family = &entities[root * (k_children_count + 1)];
+
+        component::Hierarchy root_hierarchy{};
+        root_hierarchy.children.assign(family + 1, family + 1 + k_children_count);
+        ecs_manager->add_component(family[0], root_hierarchy);
+        for (std::size_t child = 1 ; child <= k_children_count ; ++child) {
+            component::Hierarchy child_hierarchy{};
+            child_hierarchy.parent = family[0];
+            ecs_manager->add_component(family[child], child_hierarchy);
+        }
+        roots.push_back(family[0]);
+    }
+
+    ecs_manager->fixed_update(k_fixed_dt); // (initial world matrices)
+    return ecs_manager;
+}
+}
+
+void run_transform_benchmarks(std::vector<Result>& results)
+{
+    for (const std::size_t entity_count : {10'000u, 100'000u}) {
+        std::vector<EulerTransform>       euler_transforms(entity_count);
+        std::vector<component::Transform> transforms(entity_count);
+        for (std::size_t i = 0 ; i < entity_count ; ++i) {
+            const auto value          = static_cast<float>(i % 360);
+            euler_transforms[i]       = {glm::vec3(value), glm::vec3(value), glm::vec3(1.0f)};
+            transforms[i].translation = glm::vec3(value);
+            transforms[i].set_euler_angles(glm::vec3(value));
+        }
+
+        results.push_back(
+            measure("transform/compose/euler_matrices", entity_count, k_iterations, [&] {
+                float sum = 0.0f;
+                for (const auto& transform : euler_transforms) {
+                    sum += compose_euler(transform)[3].x;
+                }
+                do_not_optimize(sum);
+            }));
+
+        results.push_back(
+            measure("transform/compose/quat_trs", entity_count, k_iterations, [&] {
+                for (auto& transform : transforms) {
+                    core::TransformSystem::update_local_matrix(transform);
+                }
+                do_not_optimize(transforms.back().local_matrix[3].x);
+            }));
+
+        std::vector<ecs::Entity> roots;
+        std::vector<ecs::Entity> entities;
+        const auto               world = make_forest(entity_count / (k_children_count + 1), roots, entities);
+
+        results.push_back(
+            measure_with_setup("transform/world_update/all_changed", entities.size(), k_iterations,
+                [&] {
+                    for (const auto entity : entities) {
+                        world->mark_changed<component::Transform>(entity);
+                    }
+                },
+                [&] { world->fixed_update(k_fixed_dt); }));
+
+        // (children's cached local matrices are reused)
+        results.push_back(
+            measure_with_setup("transform/world_update/roots_changed", entities.size(), k_iterations,
+                [&] {
+                    for (const auto root : roots) {
+                        world->mark_changed<component::Transform>(root);
+                    }
+                },
+                [&] { world->fixed_update(k_fixed_dt); }));
+
+        // (a static scene: no transform changed since the last step)
+        results.push_back(
+            measure("transform/world_update/none_changed", entities.size(), k_iterations,
+                [&] { world->fixed_update(k_fixed_dt); }));
+    }
+}
+}
@@ -0,0 +1,107 @@
+// Copyright © 2024 Jacob Curlin
+
+// Compares the per-system entity set + get_component pattern against typed views (plain & group-backed)
+// for the physics integration loop.
+
+#include "bench.h"
+
+#include "ecs/ecs_manager.h"
+#include "ecs/system.h"
+#include "core/components/transform.h"
+#include "core/components/rigid_body.h"
+
+#include <memory>
+
+namespace cgx::bench
+{
+namespace
+{
+constexpr float k_dt = 1.0f / 60.0f;
+
+void integrate(component::Transform& transform, component::RigidBody& rigid_body)
+{
+    transform.translation += rigid_body.velocity * k_dt;
+    rigid_body.velocity += rigid_body.acceleration * k_dt;
+}
+
+// the iteration pattern systems used before views: walk the system's entity set, look up each component
+class SetIntegrationSystem final : public ecs::System
+{
+public:
+    explicit SetIntegrationSystem(ecs::ECSManager* ecs_manager)
+        : System(ecs_manager) {}
+
+    void frame_update(float dt) override
+    {
+        for (const auto& entity : m_entities) {
+            integrate(get_component<component::Transform>(entity), get_component<component::RigidBody>(entity));
+        }
+    }
+
+    void fixed_update(float dt) override {}
+    void on_entity_added(ecs::Entity entity) override {}
+    void on_entity_removed(ecs::Entity entity) override {}
+};
+
+// every entity gets a transform, every other one a rigid body
+std::unique_ptr<ecs::ECSManager> make_world(const std::size_t entity_count, const bool grouped)
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::RigidBody>();
+    if (grouped) {
+        ecs_manager->register_group<component::Transform, component::RigidBody>();
+    }
+
+    register_system<SetIntegrationSystem, component::Transform, component::RigidBody>(*ecs_manager);
+
+    for (std::size_t i = 0 ; i < entity_count ; ++i) {
+        const auto entity = ecs_manager->acquire_entity();
+        ecs_manager->add_component(entity, component::Transform{});
+        if (i % 2 == 0) {
+            component::RigidBody rigid_body{};
+            rigid_body.velocity = glm::vec3(1.0f, 0.0f, 0.0f);
+            ecs_manager->add_component(entity, rigid_body);
+        }
+    }
+
+    return ecs_manager;
+}
+}
+
+void run_view_benchmarks(std::vector<Result>& results)
+{
+    for (const std::size_t entity_count : {10'000u, 100'000u}) {
+        const std::size_t matching = entity_count / 2;
+
+        {
+            const auto world = make_world(entity_count, false);
+            results.push_back(
+                measure("view/system_set_get_component", matching, 20, [&] { world->frame_update(k_dt); }));
+            results.push_back(
+                measure("view/view_each", matching, 20, [&] {
+                    world->view<component::Transform, component::RigidBody>().each(
+                        [](ecs::Entity, component::Transform& transform, component::RigidBody& rigid_body) {
+                            integrate(transform, rigid_body);
+                        });
+                }));
+            results.push_back(
+                measure("view/view_range_for", matching, 20, [&] {
+                    for (auto [entity, transform, rigid_body] : world->view<component::Transform, component::RigidBody>()) {
+                        integrate(transform, rigid_body);
+                    }
+                }));
+        }
+        {
+            const auto world = make_world(entity_count, true);
+            results.push_back(
+                measure("view/group_backed_view_each", matching, 20, [&] {
+                    world->view<component::Transform, component::RigidBody>().each(
+                        [](ecs::Entity, component::Transform& transform, component::RigidBody& rigid_body) {
+                            integrate(transform, rigid_body);
+                        });
+                }));
+        }
+    }
+}
+}
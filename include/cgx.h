@@ -8,8 +8,10 @@
 #include "core/hierarchy.h"
 #include "core/item.h"
 #include "core/input_manager.h"
+#include "core/job_system.h"
 #include "physics/physics_system.h"
 #include "core/systems/time_system.h"
+#include "core/transform_table.h"
 #include "core/window_manager.h"
 
 // asset
@@ -26,14 +28,22 @@
 #include "asset/import/asset_importer_obj.h"
 
 // event & entity component system
+#include "ecs/command_buffer.h"
 #include "ecs/common.h"
 #include "ecs/component_array.h"
 #include "ecs/component_registry.h"
 #include "ecs/entity_registry.h"
+#include "ecs/group.h"
+#include "ecs/observer.h"
+#include "ecs/snapshot.h"
 #include "ecs/system.h"
 #include "ecs/system_registry.h"
+#include "ecs/view.h"
 #include "core/event.h"
+#include "core/event_channel.h"
 #include "core/event_handler.h"
+#include "core/listener_list.h"
+#include "core/mpsc_queue.h"
 
 // gui
 #include "gui/gui_context.h"
@@ -2,12 +2,34 @@
 
 #pragma once
 #include "ecs/common.h"
+#include "ecs/snapshot.h"
+
+#include <vector>
 
 namespace cgx::component
 {
 struct Hierarchy {
-    ecs::Entity parent{ecs::MAX_ENTITIES};
+    ecs::Entity parent{ecs::NULL_ENTITY};
     std::vector<ecs::Entity> children{};
     std::vector<ecs::Entity> siblings{};
 };
-}
\ No newline at end of file
+
+// snapshot encoding (see ecs/snapshot.h); entity handles survive snapshots, so links are stored as is
+inline ecs::ComponentSerializer<Hierarchy> get_hierarchy_serializer()
+{
+    return {
+        [](const Hierarchy& hierarchy, ecs::SnapshotWriter& writer) {
+            writer.write(hierarchy.parent);
+            writer.write_vector(hierarchy.children);
+            writer.write_vector(hierarchy.siblings);
+        },
+        [](ecs::SnapshotReader& reader) {
+            Hierarchy hierarchy;
+            hierarchy.parent   = reader.read<ecs::Entity>();
+            hierarchy.children = reader.read_vector<ecs::Entity>();
+            hierarchy.siblings = reader.read_vector<ecs::Entity>();
+            return hierarchy;
+        }
+    };
+}
+}
@@ -2,19 +2,37 @@
 
 #pragma once
 
+#define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/euler_angles.hpp>
 
 namespace cgx::component
 {
 struct Transform
 {
     glm::vec3 translation = glm::vec3(0.0f);
-    glm::vec3 rotation    = glm::vec3(0.0f);
-    glm::vec3 scale     = glm::vec3(1.0f);
+    glm::quat rotation    = glm::quat(1.0f, 0.0f, 0.0f, 0.0f); // (w, x, y, z)
+    glm::vec3 scale       = glm::vec3(1.0f);
 
-    glm::mat4 world_matrix = glm::mat4(1.0f);
-    bool      dirty{false};
-};
-}
+    glm::mat4 local_matrix = glm::mat4(1.0f); // (translation * rotation * scale; cached by the transform system)
+    glm::mat4 world_matrix = glm::mat4(1.0f); // (recomputed by the transform system from changed transforms)
 
+    // rotation as euler angles (pitch, yaw, roll; degrees), for editing: rotate(x) * rotate(y) * rotate(z), i.e.
+    // roll applied first & pitch last (about the parent's axes), as before rotations were stored as quaternions
+    [[nodiscard]] glm::vec3 get_euler_angles() const
+    {
+        glm::vec3 radians;
+        glm::extractEulerAngleXYZ(glm::mat4_cast(rotation), radians.x, radians.y, radians.z);
+        return glm::degrees(radians);
+    }
 
+    void set_euler_angles(const glm::vec3& degrees)
+    {
+        const glm::vec3 radians = glm::radians(degrees);
+        rotation = glm::angleAxis(radians.x, glm::vec3(1.0f, 0.0f, 0.0f))
+                   * glm::angleAxis(radians.y, glm::vec3(0.0f, 1.0f, 0.0f))
+                   * glm::angleAxis(radians.z, glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+};
+}
@@ -5,6 +5,7 @@
 #define GL_SILENCE_DEPRECATION
 
 #include "core/common.h"
+#include "core/listener_list.h"
 
 #include <filesystem>
 
@@ -44,6 +45,7 @@ namespace cgx::core
 class TimeSystem;
 class WindowManager;
 class InputManager;
+class JobSystem;
 
 struct EngineSettings
 {
@@ -82,6 +84,7 @@ protected:
 
     void setup_gui();
     void setup_engine_events();
+    void setup_component_serializers();
 
     EngineSettings m_settings{};
     bool           m_is_running{false};
@@ -90,6 +93,7 @@ protected:
 
     std::unique_ptr<TimeSystem>           m_time_system;
     std::shared_ptr<WindowManager>        m_window_manager;
+    std::unique_ptr<JobSystem>            m_job_system; // (outlives the ecs manager using it)
     std::unique_ptr<ecs::ECSManager>      m_ecs_manager;
     std::shared_ptr<scene::SceneManager>  m_scene_manager;
     std::shared_ptr<asset::AssetManager>  m_asset_manager;
@@ -97,5 +101,7 @@ protected:
     std::unique_ptr<gui::ImGuiManager>    m_imgui_manager;
     std::shared_ptr<render::RenderSystem> m_render_system;
     std::shared_ptr<audio::AudioSystem>   m_audio_system;
+
+    std::vector<Subscription> m_subscriptions{};
 };
 }
@@ -0,0 +1,346 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements typed event channels: one per event payload type, holding the listeners of that type. Payloads
+// are plain structs delivered to listeners by const reference, so sending an event neither allocates nor
+// looks anything up by name; the event handler resolves a type's channel through a per-type family index.
+//
+// Events can also be queued, to be delivered when the event handler flushes the channel's delivery phase
+// (once per frame). Batch listeners receive every event of a flush at once, so work triggered by a burst of
+// events (e.g. hundreds of parent updates during a scene import) can be done once. Event types specializing
+// EventCoalescing are merged while queued: an event whose key matches one already queued is folded into it.
+//
+//     struct ParentUpdated { ecs::Entity child; ecs::Entity old_parent; ecs::Entity new_parent; };
+//
+//     m_subscription = event_handler.add_listener<ParentUpdated>([](const ParentUpdated& event) { ... });
+//     event_handler.add_batch_listener<ParentUpdated>([](std::span<const ParentUpdated> events) { ... });
+//     event_handler.send(ParentUpdated{child, old_parent, new_parent});    // delivered now
+//     event_handler.enqueue(ParentUpdated{child, old_parent, new_parent}); // delivered at the next flush
+//
+// Channels are used from the main thread; other threads hand events over through EventHandler::post.
+// Listeners with worker affinity are invoked on the job system rather than the delivering thread; unsubscribing
+// one waits for the worker jobs in flight. Adding a listener returns a subscription (see core/listener_list.h)
+// keeping it registered.
+
+#pragma once
+
+#include "core/job_system.h"
+#include "core/listener_list.h"
+#include "utility/demangle.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <source_location>
+#include <span>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace cgx::core
+{
+// Assigns each event payload type a process-wide index the first time it is used (cf. ecs::ComponentFamily).
+class EventFamily
+{
+public:
+    template<typename E>
+    static std::size_t get()
+    {
+        static const std::size_t family = next();
+        return family;
+    }
+
+private:
+    static std::size_t next()
+    {
+        static std::atomic<std::size_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// Specialize to merge queued events of type E sharing a key (e.g. repeated updates of one entity):
+//
+//     template<>
+//     struct EventCoalescing<ParentUpdated>
+//     {
+//         static constexpr bool enabled = true;
+//         static std::uint64_t  get_key(const ParentUpdated& event) { return event.child; }
+//         static void           merge(ParentUpdated& queued, const ParentUpdated& event) { ... }
+//     };
+//
+// A merged event keeps the queue position of the first event with its key.
+template<typename E>
+struct EventCoalescing
+{
+    static constexpr bool enabled = false;
+};
+
+// Maps the coalescing keys of queued events to their queue indices. Open addressing (linear probing) over a
+// power-of-two table that keeps its capacity across flushes; clearing bumps an epoch rather than touching the
+// slots, so a frame's coalescing allocates nothing once the table has grown to the frame's key count.
+class CoalescingIndex
+{
+public:
+    // Returns the index queued under 'key' & false, or inserts 'index' & returns it & true.
+    std::pair<std::uint32_t, bool> try_emplace(const std::uint64_t key, const std::uint32_t index)
+    {
+        if ((m_size + 1) * 2 > m_slots.size()) {
+            grow();
+        }
+        Slot& slot = find(m_slots, key);
+        if (slot.epoch == m_epoch) {
+            return {slot.index, false};
+        }
+        slot = {key, index, m_epoch};
+        ++m_size;
+        return {index, true};
+    }
+
+    void clear()
+    {
+        m_size = 0;
+        if (++m_epoch == 0) {
+            // (epoch wrapped: stale slots could be mistaken for live ones)
+            for (auto& slot : m_slots) {
+                slot.epoch = 0;
+            }
+            m_epoch = 1;
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+        std::uint32_t epoch; // live if it equals m_epoch
+    };
+
+    std::vector<Slot> m_slots{};
+    std::uint32_t     m_epoch{1};
+    std::size_t       m_size{0};
+
+    // the slot holding 'key', or the empty slot ending its probe sequence
+    Slot& find(std::vector<Slot>& slots, const std::uint64_t key) const
+    {
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t position = get_hash(key) & mask ; ; position = (position + 1) & mask) {
+            Slot& slot = slots[position];
+            if (slot.epoch != m_epoch || slot.key == key) {
+                return slot;
+            }
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> slots(m_slots.empty() ? 16 : m_slots.size() * 2, Slot{0, 0, 0});
+        for (const auto& slot : m_slots) {
+            if (slot.epoch == m_epoch) {
+                find(slots, slot.key) = slot;
+            }
+        }
+        m_slots.swap(slots);
+    }
+
+    // (keys are often entity handles, whose low bits are sequential)
+    static std::size_t get_hash(std::uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        return static_cast<std::size_t>(key);
+    }
+};
+
+// recorded dispatches of one listener (see EventHandler::get_listener_profiles)
+struct ListenerProfile
+{
+    std::string   event;    // payload type name, or event id (EventId-keyed events)
+    std::string   listener; // where the listener was subscribed ("file:line")
+    bool          batch;    // batch listener
+    ListenerStats stats;
+};
+
+// label of a listener subscribed at 'location', for its profile
+std::string get_listener_label(const std::source_location& location);
+
+// points of the frame at which queued events are delivered (see Engine::update)
+enum class EventPhase : std::uint8_t
+{
+    PreUpdate,  // before systems update
+    PostUpdate, // after systems update, before rendering
+    Count
+};
+
+class IEventChannel
+{
+public:
+    virtual ~IEventChannel() = default;
+
+    // delivers the events queued so far; events queued meanwhile wait for the next flush
+    virtual void flush() = 0;
+
+    [[nodiscard]] EventPhase get_phase() const { return m_phase; }
+    void                     set_phase(const EventPhase phase) { m_phase = phase; }
+
+    // Jobs invoking worker-affinity listeners are submitted to 'job_system' & tracked by 'counter'; without a
+    // job system, such listeners are invoked by the delivering thread.
+    void set_job_system(JobSystem* job_system, JobCounter* counter)
+    {
+        m_job_system     = job_system;
+        m_worker_counter = counter;
+    }
+
+#if defined(CGX_EVENT_PROFILING)
+    virtual void collect_profiles(std::vector<ListenerProfile>& profiles) const = 0;
+    virtual void reset_profiles() = 0;
+#endif
+
+protected:
+    JobSystem*  m_job_system{nullptr};
+    JobCounter* m_worker_counter{nullptr};
+
+private:
+    EventPhase m_phase{EventPhase::PreUpdate};
+};
+
+template<typename E>
+class EventChannel final : public IEventChannel
+{
+public:
+    using Listener      = std::function<void(const E&)>;
+    using BatchListener = std::function<void(std::span<const E>)>;
+
+    EventChannel()
+    {
+        m_listeners.set_worker_barrier([this] {
+            if (m_job_system != nullptr) {
+                m_job_system->wait(*m_worker_counter);
+            }
+        });
+    }
+
+    // ('location' labels the listener's profile; defaults to the caller)
+    [[nodiscard]] Subscription add_listener(Listener                   listener,
+                                            const ListenerAffinity     affinity = ListenerAffinity::MainThread,
+                                            const ListenerPriority     priority = k_default_listener_priority,
+                                            const std::source_location location = std::source_location::current())
+    {
+        return m_listeners.add(std::move(listener), affinity, priority, location);
+    }
+
+    // Batch listeners only receive queued events, once per flush; sent events are delivered to them as a
+    // batch of one.
+    [[nodiscard]] Subscription add_batch_listener(BatchListener              listener,
+                                                  const ListenerPriority     priority = k_default_listener_priority,
+                                                  const std::source_location location = std::source_location::current())
+    {
+        return m_batch_listeners.add(std::move(listener), ListenerAffinity::MainThread, priority, location);
+    }
+
+    void send(const E& event)
+    {
+        deliver(std::span<const E>(&event, 1));
+    }
+
+    // Queues 'event' for the next flush (or merges it into a queued one); returns true if it's the first event
+    // queued since the last one.
+    bool enqueue(const E& event)
+    {
+        if constexpr (EventCoalescing<E>::enabled) {
+            const auto [index, inserted] = m_queued_indices.try_emplace(
+                EventCoalescing<E>::get_key(event), static_cast<std::uint32_t>(m_queue.size()));
+            if (!inserted) {
+                EventCoalescing<E>::merge(m_queue[index], event);
+                return false;
+            }
+        }
+        m_queue.push_back(event);
+        return m_queue.size() == 1;
+    }
+
+    void flush() override
+    {
+        m_delivering.swap(m_queue);
+        m_queued_indices.clear();
+        deliver(std::span<const E>(m_delivering));
+        m_delivering.clear(); // (keeps its capacity for the next frame)
+    }
+
+    [[nodiscard]] std::size_t get_listener_count() const { return m_listeners.size() + m_batch_listeners.size(); }
+    [[nodiscard]] std::size_t get_queued_count() const { return m_queue.size(); }
+
+#if defined(CGX_EVENT_PROFILING)
+    void collect_profiles(std::vector<ListenerProfile>& profiles) const override
+    {
+        const std::string event = utility::get_unqualified_name(typeid(E).name());
+        m_listeners.for_each_stats([&](const auto& entry) {
+            profiles.push_back({event, get_listener_label(entry.location), false, entry.stats});
+        });
+        m_batch_listeners.for_each_stats([&](const auto& entry) {
+            profiles.push_back({event, get_listener_label(entry.location), true, entry.stats});
+        });
+    }
+
+    void reset_profiles() override
+    {
+        m_listeners.reset_stats();
+        m_batch_listeners.reset_stats();
+    }
+#endif
+
+private:
+    ListenerList<Listener>      m_listeners{};
+    ListenerList<BatchListener> m_batch_listeners{};
+
+    std::vector<E> m_queue{};
+    std::vector<E> m_delivering{}; // (the queue being flushed)
+
+    CoalescingIndex m_queued_indices{}; // coalescing key -> index in m_queue
+
+    void deliver(const std::span<const E> events)
+    {
+        if (events.empty()) {
+            return;
+        }
+
+        m_batch_listeners.dispatch([events](const auto& entry) { entry.func(events); });
+
+        const bool has_workers = m_job_system != nullptr;
+        for (const auto& event : events) {
+            m_listeners.dispatch([&event, has_workers](const auto& entry) {
+                if (entry.affinity == ListenerAffinity::MainThread || !has_workers) {
+                    entry.func(event);
+                }
+            });
+        }
+        if (has_workers) {
+            dispatch_to_workers(events);
+        }
+    }
+
+    // one job per worker-affinity listener, over a copy of the events (& of the listener; see ListenerAffinity)
+    void dispatch_to_workers(const std::span<const E> events)
+    {
+        std::shared_ptr<const std::vector<E>> copy;
+        m_listeners.for_each([&](const auto& entry) {
+            if (entry.affinity != ListenerAffinity::Worker) {
+                return;
+            }
+            if (copy == nullptr) {
+                copy = std::make_shared<const std::vector<E>>(events.begin(), events.end());
+            }
+            m_job_system->submit(
+                [func = entry.func, copy] {
+                    for (const auto& event : *copy) {
+                        func(event);
+                    }
+                },
+                m_worker_counter);
+        });
+    }
+};
+}
@@ -1,12 +1,24 @@
 // Copyright © 2024 Jacob Curlin
 
+// Dispatches events through typed channels (see core/event_channel.h). The EventId-keyed events carrying
+// an std::any parameter map remain available as a compatibility layer for infrequent events (input
+// bindings, mode toggles); frequent events should use typed payloads.
+//
+// The event handler is used from the main thread, except for 'post': any thread may post typed events, which
+// are handed over through a lock-free queue & queued on their channels at the next flush.
+
 #pragma once
 
 #include "event.h"
+#include "event_channel.h"
+#include "mpsc_queue.h"
 
-#include <list>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 namespace cgx::core
 {
@@ -20,14 +32,196 @@ public:
 
     static EventHandler& get_instance();
 
-    void add_listener(event::EventId event_id, std::function<void(event::Event&)> const& listener);
+    // typed events
+    // (listeners stay registered while the returned subscription is alive; 'location', the caller by default,
+    // labels their profiles)
+    template<typename E>
+    [[nodiscard]] Subscription add_listener(typename EventChannel<E>::Listener listener,
+                                            const ListenerAffinity         affinity = ListenerAffinity::MainThread,
+                                            const ListenerPriority         priority = k_default_listener_priority,
+                                            const std::source_location     location = std::source_location::current())
+    {
+        return get_channel<E>().add_listener(std::move(listener), affinity, priority, location);
+    }
+
+    template<typename E>
+    [[nodiscard]] Subscription add_batch_listener(typename EventChannel<E>::BatchListener listener,
+                                                  const ListenerPriority priority = k_default_listener_priority,
+                                                  const std::source_location location = std::source_location::current())
+    {
+        return get_channel<E>().add_batch_listener(std::move(listener), priority, location);
+    }
+
+    template<typename E>
+    void send(const E& event)
+    {
+        get_channel<E>().send(event);
+    }
+
+    // Queues 'event' for delivery at the next flush of E's delivery phase.
+    template<typename E>
+    void enqueue(const E& event)
+    {
+        if (auto& channel = get_channel<E>() ; channel.enqueue(event)) {
+            m_queued_channels[static_cast<std::size_t>(channel.get_phase())].push_back(&channel);
+        }
+    }
+
+    // Hands 'event' over for queueing on E's channel at the next flush (of any phase). Safe from any thread;
+    // allocates only while more events of type E are in flight than ever before (see PostedEvent).
+    template<typename E>
+    void post(const E& event)
+    {
+        m_posted_events.push(PostedEvent<E>::acquire(event));
+    }
+
+    // Sets the phase at which queued events of type E are delivered (PreUpdate by default).
+    template<typename E>
+    void set_delivery_phase(const EventPhase phase)
+    {
+        get_channel<E>().set_phase(phase);
+    }
+
+    // Queues posted events, then delivers the events queued for 'phase'; events queued by listeners meanwhile
+    // wait for the next flush. First waits for worker-affinity listeners still handling earlier deliveries.
+    void flush(EventPhase phase);
+
+    // Delivers the events of type E queued so far right away, ahead of their phase (e.g. so links made by a
+    // scene import apply before the next update rather than after it).
+    template<typename E>
+    void flush()
+    {
+        wait_for_worker_listeners();
+        get_channel<E>().flush();
+    }
+
+    // Job system running worker-affinity listeners (none: they run on the main thread). Waits for listeners
+    // still running on the previous one.
+    void set_job_system(JobSystem* job_system);
+
+    template<typename E>
+    EventChannel<E>& get_channel()
+    {
+        const std::size_t family = EventFamily::get<E>();
+        if (family >= m_channels.size()) {
+            m_channels.resize(family + 1);
+        }
+        if (m_channels[family] == nullptr) {
+            m_channels[family] = std::make_unique<EventChannel<E>>();
+            m_channels[family]->set_job_system(m_job_system, &m_worker_counter);
+        }
+        return static_cast<EventChannel<E>&>(*m_channels[family]);
+    }
+
+    // Dispatch counts & times of every registered listener, if built with CGX_EVENT_PROFILING (else empty).
+    [[nodiscard]] std::vector<ListenerProfile> get_listener_profiles() const;
+    void                                       reset_listener_profiles();
+
+    // EventId-keyed events (compatibility)
+    [[nodiscard]] Subscription add_listener(event::EventId                      event_id,
+                                            std::function<void(event::Event&)> listener,
+                                            ListenerPriority                    priority = k_default_listener_priority,
+                                            std::source_location location = std::source_location::current());
     void send_event(event::Event& event);
     void send_event(event::EventId event_id);
 
 private:
     EventHandler();
+    ~EventHandler();
+
+    struct IPostedEvent : MpscNode
+    {
+        virtual      ~IPostedEvent() = default;
+        virtual void enqueue(EventHandler& event_handler) const = 0;
+        virtual void release() = 0; // (flushing thread, once enqueued)
+    };
+
+    // Posted event nodes are recycled per payload type. The flushing thread pushes released nodes onto a shared
+    // free stack; a posting thread takes the whole stack (one atomic exchange, so no ABA) into its own cache
+    // once that runs dry, & only allocates if both are empty.
+    template<typename E>
+    struct PostedEvent final : IPostedEvent
+    {
+        explicit PostedEvent(const E& event)
+            : event(event) {}
+
+        static PostedEvent* acquire(const E& event)
+        {
+            FreeList& cache = get_cache();
+            if (cache.head == nullptr) {
+                cache.head = get_shared().head.exchange(nullptr, std::memory_order_acquire);
+            }
+            if (cache.head == nullptr) {
+                return new PostedEvent(event);
+            }
+            PostedEvent* node = cache.head;
+            cache.head        = node->next_free;
+            node->event       = event;
+            return node;
+        }
+
+        void enqueue(EventHandler& event_handler) const override
+        {
+            event_handler.enqueue(event);
+        }
+
+        void release() override
+        {
+            auto& shared = get_shared().head;
+            next_free    = shared.load(std::memory_order_relaxed);
+            while (!shared.compare_exchange_weak(next_free, this, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {}
+        }
+
+        E            event;
+        PostedEvent* next_free{nullptr};
+
+    private:
+        // (frees the nodes it holds on thread / program exit)
+        template<typename Head>
+        struct FreeListBase
+        {
+            Head head{nullptr};
+
+            ~FreeListBase()
+            {
+                for (PostedEvent* node = head ; node != nullptr ;) {
+                    PostedEvent* next = node->next_free;
+                    delete node;
+                    node = next;
+                }
+            }
+        };
+        using FreeList       = FreeListBase<PostedEvent*>;
+        using SharedFreeList = FreeListBase<std::atomic<PostedEvent*>>;
+
+        static FreeList& get_cache()
+        {
+            thread_local FreeList cache;
+            return cache;
+        }
+
+        static SharedFreeList& get_shared()
+        {
+            static SharedFreeList shared;
+            return shared;
+        }
+    };
+
+    MpscQueue  m_posted_events{};
+    JobSystem* m_job_system{nullptr};
+    JobCounter m_worker_counter{}; // worker-affinity listener jobs in flight
+
+    void enqueue_posted_events();
+    void wait_for_worker_listeners();
+
+    std::vector<std::unique_ptr<IEventChannel>> m_channels{}; // indexed by event family
+
+    // channels holding queued events, per delivery phase
+    std::array<std::vector<IEventChannel*>, static_cast<std::size_t>(EventPhase::Count)> m_queued_channels{};
+    std::vector<IEventChannel*>                                                          m_flushing_channels{};
 
-    std::unordered_map<event::EventId, std::list<std::function<void(event::Event&)>>> m_listeners;
+    std::unordered_map<event::EventId, ListenerList<std::function<void(event::Event&)>>> m_listeners;
 };
 }
 
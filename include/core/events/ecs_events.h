@@ -3,6 +3,8 @@
 #pragma once
 
 #include "core/event.h"
+#include "core/event_channel.h"
+#include "ecs/common.h"
 
 namespace cgx::core::event::entity
 {
@@ -24,10 +26,34 @@ constexpr ParamId ENTITY_ID = "event::component::ENTITY_ID"_hash;
 
 namespace cgx::core::event::component::hierarchy
 {
-constexpr EventId PARENT_UPDATE = "event::component::hierarchy::PARENT_UPDATE"_hash;
-constexpr ParamId OLD_PARENT    = "event::component::hierarchy::OLD_PARENT"_hash;
-constexpr ParamId NEW_PARENT    = "event::component::hierarchy::NEW_PARENT"_hash;
-constexpr ParamId CHILD         = "event::component::hierarchy::CHILD"_hash;
+// queued once per reparented node (typed; see core/event_channel.h)
+struct ParentUpdated
+{
+    ecs::Entity child;
+    ecs::Entity old_parent;
+    ecs::Entity new_parent;
+};
+}
+
+namespace cgx::core
+{
+// a node reparented several times within a frame is updated once, from its first old parent to its last new one
+template<>
+struct EventCoalescing<event::component::hierarchy::ParentUpdated>
+{
+    static constexpr bool enabled = true;
+
+    static std::uint64_t get_key(const event::component::hierarchy::ParentUpdated& event)
+    {
+        return event.child;
+    }
+
+    static void merge(event::component::hierarchy::ParentUpdated&       queued,
+                      const event::component::hierarchy::ParentUpdated& event)
+    {
+        queued.new_parent = event.new_parent;
+    }
+};
 }
 
 namespace cgx::core::event::system
@@ -0,0 +1,131 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements a fixed pool of worker threads executing jobs from per-thread work-stealing deques. Each worker
+// pushes & pops jobs at the back of its own deque (most recently submitted first, while its data is still
+// warm) and, once empty, steals from the front of the other deques. Threads outside the pool (e.g. the main
+// thread) share one additional deque.
+//
+// Completion is tracked through counters: a job submitted with a counter increments it, and decrements it
+// once finished. Jobs may be submitted with a dependency counter, in which case they're only queued once that
+// counter reaches zero. 'wait' runs queued jobs until a counter reaches zero, so waiting from within a job
+// (or from a pool without workers) cannot deadlock. A counter may be destroyed once 'wait' on it has returned.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgx::core
+{
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&)            = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    [[nodiscard]] bool is_done() const
+    {
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation
+    {
+        std::function<void()> job;
+        JobCounter*           counter;
+    };
+
+    std::atomic<std::size_t>  m_pending{0};
+    mutable std::mutex        m_mutex{};
+    std::vector<Continuation> m_continuations{}; // jobs waiting for this counter to reach zero
+};
+
+class JobSystem
+{
+public:
+    // one worker per hardware thread besides the calling thread
+    static std::size_t get_default_worker_count();
+
+    explicit JobSystem(std::size_t worker_count = get_default_worker_count());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queues 'job'. If 'counter' is given, it's incremented now & decremented once the job has finished.
+    // If 'dependency' is given, the job is only queued once that counter reaches zero.
+    void submit(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // Runs queued jobs on the calling thread until 'counter' reaches zero.
+    void wait(const JobCounter& counter);
+
+    // Splits [begin, end) into chunks of 'grain_size' indices & invokes 'func(chunk_begin, chunk_end)' for each,
+    // spread across the pool (the calling thread included). Returns once every chunk has been processed.
+    template<typename Func>
+    void parallel_for(const std::size_t begin, const std::size_t end, std::size_t grain_size, Func&& func)
+    {
+        if (begin >= end) {
+            return;
+        }
+        grain_size = std::max<std::size_t>(grain_size, 1);
+        if (m_workers.empty() || end - begin <= grain_size) {
+            func(begin, end);
+            return;
+        }
+
+        JobCounter counter;
+        for (std::size_t chunk_begin = begin + grain_size ; chunk_begin < end ; chunk_begin += grain_size) {
+            const std::size_t chunk_end = std::min(chunk_begin + grain_size, end);
+            submit([&func, chunk_begin, chunk_end] { func(chunk_begin, chunk_end); }, &counter);
+        }
+        func(begin, begin + grain_size); // (the calling thread takes the first chunk)
+        wait(counter);
+    }
+
+    [[nodiscard]] std::size_t get_worker_count() const { return m_workers.size(); }
+
+    // number of threads jobs may run on (workers & a calling thread)
+    [[nodiscard]] std::size_t get_thread_count() const { return m_workers.size() + 1; }
+
+private:
+    struct Job
+    {
+        std::function<void()> func;
+        JobCounter*           counter;
+    };
+
+    // padded to keep neighbouring deques' locks off each other's cache lines
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex      mutex{};
+        std::deque<Job> jobs{};
+    };
+
+    std::vector<std::thread>                  m_workers{};
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues{}; // [0]: threads outside the pool, [i + 1]: worker i
+
+    std::atomic<std::size_t> m_queued_jobs{0};
+    std::mutex               m_sleep_mutex{};
+    std::condition_variable  m_wake_condition{};
+    bool                     m_stopping{false};
+
+    [[nodiscard]] std::size_t get_queue_index() const;
+
+    void push(Job job);
+    bool try_pop(Job& job);
+    void run(Job& job);
+    void worker_loop(std::size_t queue_index);
+};
+}
@@ -0,0 +1,313 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements the listener storage behind events: a flat vector of listeners, invoked by descending priority
+// (& in the order added within a priority), & RAII subscriptions removing a listener when destroyed. Listeners
+// are addressed by id through a position table, so unsubscribing is O(1): the entry is only deactivated, &
+// deactivated entries are compacted away once no dispatch is running (after a dispatch, or once they make up
+// half the list). Listeners may subscribe & unsubscribe (themselves included) while being dispatched to;
+// listeners added meanwhile are first invoked by the next dispatch.
+//
+// Built with CGX_EVENT_PROFILING, each entry also records how often & how long its listener ran, & where it was
+// subscribed (see EventHandler::get_listener_profiles); otherwise nothing is recorded or stored.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <source_location>
+#include <utility>
+#include <vector>
+
+#if defined(CGX_EVENT_PROFILING)
+#include <algorithm>
+#include <chrono>
+#endif
+
+namespace cgx::core
+{
+// thread a listener is invoked on
+enum class ListenerAffinity : std::uint8_t
+{
+    MainThread, // invoked by the delivering (main) thread
+    Worker      // invoked from a job; must only touch thread-safe state. Jobs run on a copy of the listener, so
+                // unsubscribing waits for the jobs in flight: whatever it captures may go once that returns.
+};
+
+// Listeners of higher priority are invoked first (worker-affinity listeners: submitted first).
+using ListenerPriority = std::int32_t;
+
+constexpr ListenerPriority k_default_listener_priority = 0;
+
+#if defined(CGX_EVENT_PROFILING)
+constexpr bool k_event_profiling = true;
+#else
+constexpr bool k_event_profiling = false;
+#endif
+
+// dispatches of one listener (main-thread affinity only; worker listeners run outside the frame)
+struct ListenerStats
+{
+    std::uint64_t dispatch_count{0};
+    std::uint64_t total_ns{0};
+    std::uint64_t max_ns{0};
+};
+
+class IListenerList
+{
+public:
+    virtual void remove_listener(std::uint32_t id) = 0;
+
+protected:
+    ~IListenerList() = default;
+};
+
+// Keeps a listener subscribed for as long as it's alive (moving it transfers the subscription). Must not
+// outlive the event handler it was obtained from.
+class Subscription
+{
+public:
+    Subscription() = default;
+
+    Subscription(IListenerList* listener_list, const std::uint32_t id)
+        : m_listener_list(listener_list)
+        , m_id(id) {}
+
+    ~Subscription() { reset(); }
+
+    Subscription(const Subscription&)            = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    Subscription(Subscription&& other) noexcept
+        : m_listener_list(std::exchange(other.m_listener_list, nullptr))
+        , m_id(other.m_id) {}
+
+    Subscription& operator=(Subscription&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            m_listener_list = std::exchange(other.m_listener_list, nullptr);
+            m_id            = other.m_id;
+        }
+        return *this;
+    }
+
+    // unsubscribes now
+    void reset()
+    {
+        if (m_listener_list != nullptr) {
+            m_listener_list->remove_listener(m_id);
+            m_listener_list = nullptr;
+        }
+    }
+
+    [[nodiscard]] bool is_active() const { return m_listener_list != nullptr; }
+
+private:
+    IListenerList* m_listener_list{nullptr};
+    std::uint32_t  m_id{0};
+};
+
+template<typename Func>
+class ListenerList final : public IListenerList
+{
+public:
+    struct Entry
+    {
+        Func             func;
+        ListenerAffinity affinity;
+        ListenerPriority priority;
+        std::uint32_t    id;
+        bool             active;
+#if defined(CGX_EVENT_PROFILING)
+        ListenerStats        stats{};
+        std::source_location location{}; // (of the subscribing call)
+#endif
+    };
+
+    ListenerList() = default;
+
+    // (subscriptions refer to the list by address)
+    ListenerList(const ListenerList&)            = delete;
+    ListenerList& operator=(const ListenerList&) = delete;
+
+    // ('location' labels the listener's profile; defaults to the caller)
+    [[nodiscard]] Subscription add(Func                                        func,
+                                   const ListenerAffinity                      affinity = ListenerAffinity::MainThread,
+                                   const ListenerPriority                      priority = k_default_listener_priority,
+                                   [[maybe_unused]] const std::source_location location = std::source_location::current())
+    {
+        std::uint32_t id;
+        if (!m_free_ids.empty()) {
+            id = m_free_ids.back();
+            m_free_ids.pop_back();
+        }
+        else {
+            id = static_cast<std::uint32_t>(m_positions.size());
+            m_positions.push_back(0);
+        }
+
+        Entry entry{std::move(func), affinity, priority, id, true};
+#if defined(CGX_EVENT_PROFILING)
+        entry.location = location;
+#endif
+
+        // (entries added while dispatching are held back, so dispatch never sees the vector reallocate)
+        if (m_dispatching > 0) {
+            m_positions[id] = static_cast<std::uint32_t>(m_pending.size()) | k_pending_bit;
+            m_pending.push_back(std::move(entry));
+        }
+        else {
+            insert(std::move(entry));
+        }
+        return {this, id};
+    }
+
+    void remove_listener(const std::uint32_t id) override
+    {
+        const std::uint32_t position = m_positions[id];
+        Entry& entry = (position & k_pending_bit) != 0 ? m_pending[position & ~k_pending_bit] : m_entries[position];
+
+        entry.active = false; // (its function may be running; destroyed once compacted)
+        m_free_ids.push_back(id);
+        ++m_inactive_count;
+
+        if (entry.affinity == ListenerAffinity::Worker && m_worker_barrier) {
+            m_worker_barrier();
+        }
+
+        if (m_dispatching == 0 && m_inactive_count * 2 >= m_entries.size()) {
+            compact();
+        }
+    }
+
+    // Invokes 'invoke(entry)' for every active entry, by descending priority.
+    template<typename Invoke>
+    void dispatch(Invoke&& invoke)
+    {
+        visit<true>(invoke);
+    }
+
+    // as dispatch, without recording listener stats (for passes not running the listeners themselves)
+    template<typename Invoke>
+    void for_each(Invoke&& invoke)
+    {
+        visit<false>(invoke);
+    }
+
+#if defined(CGX_EVENT_PROFILING)
+    // Invokes 'visit(entry)' for every active entry, pending ones included (entries hold their stats).
+    template<typename Visit>
+    void for_each_stats(Visit&& visit) const
+    {
+        for (const auto* entries : {&m_entries, &m_pending}) {
+            for (const auto& entry : *entries) {
+                if (entry.active) {
+                    visit(entry);
+                }
+            }
+        }
+    }
+
+    void reset_stats()
+    {
+        for (auto* entries : {&m_entries, &m_pending}) {
+            for (auto& entry : *entries) {
+                entry.stats = {};
+            }
+        }
+    }
+#endif
+
+    // Invoked when a worker-affinity listener is removed, to wait for the jobs still invoking it.
+    void set_worker_barrier(std::function<void()> barrier) { m_worker_barrier = std::move(barrier); }
+
+    [[nodiscard]] std::size_t size() const { return m_entries.size() + m_pending.size() - m_inactive_count; }
+    [[nodiscard]] bool        empty() const { return size() == 0; }
+
+private:
+    static constexpr std::uint32_t k_pending_bit = 1u << 31;
+
+    std::vector<Entry>         m_entries{};
+    std::vector<Entry>         m_pending{};   // added during dispatch
+    std::vector<std::uint32_t> m_positions{}; // indexed by id; position within m_entries (or m_pending)
+    std::vector<std::uint32_t> m_free_ids{};
+    std::size_t                m_inactive_count{0};
+    std::uint32_t              m_dispatching{0}; // depth of nested dispatches
+    std::function<void()>      m_worker_barrier{};
+
+    template<bool RecordStats, typename Invoke>
+    void visit(Invoke& invoke)
+    {
+        ++m_dispatching;
+        const std::size_t count = m_entries.size();
+        for (std::size_t i = 0 ; i < count ; ++i) {
+            if (!m_entries[i].active) {
+                continue;
+            }
+#if defined(CGX_EVENT_PROFILING)
+            if constexpr (RecordStats) {
+                if (m_entries[i].affinity == ListenerAffinity::MainThread) {
+                    const auto start = std::chrono::steady_clock::now();
+                    invoke(m_entries[i]);
+                    const auto elapsed = static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+                    auto& stats = m_entries[i].stats; // (entries don't move while dispatching)
+                    ++stats.dispatch_count;
+                    stats.total_ns += elapsed;
+                    stats.max_ns = std::max(stats.max_ns, elapsed);
+                    continue;
+                }
+            }
+#endif
+            invoke(m_entries[i]);
+        }
+        --m_dispatching;
+
+        if (m_dispatching == 0 && (m_inactive_count > 0 || !m_pending.empty())) {
+            compact();
+        }
+    }
+
+    // inserts 'entry' after the entries of higher or equal priority
+    void insert(Entry&& entry)
+    {
+        std::size_t position = m_entries.size();
+        while (position > 0 && m_entries[position - 1].priority < entry.priority) {
+            --position;
+        }
+        m_entries.insert(m_entries.begin() + static_cast<std::ptrdiff_t>(position), std::move(entry));
+        for (std::size_t i = position ; i < m_entries.size() ; ++i) {
+            if (m_entries[i].active) { // (ids of inactive entries may have been reused already)
+                m_positions[m_entries[i].id] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+
+    // drops inactive entries & inserts pending ones (keeping the order of the rest)
+    void compact()
+    {
+        std::size_t kept = 0;
+        for (std::size_t i = 0 ; i < m_entries.size() ; ++i) {
+            if (!m_entries[i].active) {
+                continue;
+            }
+            if (kept != i) {
+                m_entries[kept] = std::move(m_entries[i]);
+            }
+            m_positions[m_entries[kept].id] = static_cast<std::uint32_t>(kept);
+            ++kept;
+        }
+        m_entries.erase(m_entries.begin() + static_cast<std::ptrdiff_t>(kept), m_entries.end());
+
+        for (auto& entry : m_pending) {
+            if (entry.active) {
+                insert(std::move(entry));
+            }
+        }
+        m_pending.clear();
+        m_inactive_count = 0;
+    }
+};
+}
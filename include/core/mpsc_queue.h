@@ -0,0 +1,74 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements an intrusive, unbounded multi-producer / single-consumer queue (after Dmitry Vyukov's design).
+// Any thread may push; a single thread pops. Pushing is one atomic exchange & never blocks or allocates
+// (nodes are owned by the caller). A pop racing a push that hasn't completed yet may miss that node, which is
+// then returned by a later pop.
+
+#pragma once
+
+#include <atomic>
+
+namespace cgx::core
+{
+struct MpscNode
+{
+    std::atomic<MpscNode*> next{nullptr};
+};
+
+class MpscQueue
+{
+public:
+    MpscQueue() = default;
+
+    MpscQueue(const MpscQueue&)            = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // (any thread)
+    void push(MpscNode* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Returns the oldest node, or nullptr if the queue is (or appears, mid-push) empty. (consumer thread only)
+    MpscNode* pop()
+    {
+        MpscNode* tail = m_tail;
+        MpscNode* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            m_tail = next;
+            tail   = next;
+            next   = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr; // (a producer is between its exchange & linking its node)
+        }
+
+        // 'tail' is the last node; re-insert the stub behind it so it can be unlinked
+        push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    MpscNode               m_stub{};
+    std::atomic<MpscNode*> m_head{&m_stub}; // most recently pushed
+    MpscNode*              m_tail{&m_stub}; // next to pop (consumer only)
+};
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ecs/system.h"
+#include "core/listener_list.h"
 
 #include <glm/glm.hpp>
 
@@ -32,6 +33,8 @@ public:
 private:
     bool m_enabled{false};
 
+    std::vector<Subscription> m_subscriptions{};
+
     bool m_forward{false};
     bool m_backward{false};
     bool m_left{false};
@@ -1,10 +1,26 @@
 // Copyright © 2024 Jacob Curlin
 
+// Keeps the entities holding a hierarchy component in depth-first order (parents before children). The order is
+// maintained incrementally: new nodes & reparented subtrees are spliced in at the end of their parent's subtree,
+// removed nodes are tombstoned & compacted away on the next 'get_order'. Changes touching a large share of the
+// nodes at once (and everything between 'begin_batch' & 'end_batch') rebuild the order in a single pass instead.
+// The transform system builds its flattened transform table from this order.
+//
+// A splice shifts every node after its insertion point (as does removing a node with children), so it costs
+// O(N) unless it lands at the end of the order: nodes added depth-first (each ending its parent's subtree) only
+// pay for their depth, while an incremental build in any other order is O(N^2) overall. Builds that don't add
+// their nodes depth-first should be wrapped in a batch.
+
 #pragma once
 
 #include "ecs/system.h"
 #include "core/components/hierarchy.h"
-#include <unordered_set>
+#include "core/events/ecs_events.h"
+#include "core/listener_list.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
 
 namespace cgx::core
 {
@@ -19,15 +35,71 @@ public:
 
     void on_entity_added(ecs::Entity entity) override;
     void on_entity_removed(ecs::Entity entity) override;
+    void on_entities_added(const std::vector<ecs::Entity>& entities) override;
+    void on_entities_removed(const std::vector<ecs::Entity>& entities) override;
 
     void on_parent_update(ecs::Entity child, ecs::Entity old_parent, ecs::Entity new_parent);
 
-    void sort_order_by_depth();
-    void dfs_children(ecs::Entity entity, std::unordered_set<ecs::Entity>& visited);
+    // Applies a frame's queued parent updates, in order. Updates of nodes released (or not yet given a
+    // hierarchy component) since are skipped.
+    void on_parent_updates(std::span<const event::component::hierarchy::ParentUpdated> events);
+
+    // Between these, membership & parent changes only mark the order stale; it is rebuilt once by the outermost
+    // 'end_batch' (for imports & other bulk changes). Batches nest.
+    void begin_batch();
+    void end_batch();
+
+    // Entities in depth-first order (parents before children). Every node is placed below its parent, whether or
+    // not the parent lists it as a child; nodes whose parent isn't a node (until it becomes one), & nodes whose
+    // parent lies below them (cycles), are roots.
+    [[nodiscard]] const std::vector<ecs::Entity>& get_order();
 
-    [[nodiscard]] const std::vector<ecs::Entity>& get_order() const;
+    // the node 'entity' is placed below in the order (NULL_ENTITY for roots & entities that aren't nodes); as of
+    // the last 'get_order'
+    [[nodiscard]] ecs::Entity get_parent(ecs::Entity entity) const;
 
 private:
-    std::vector<ecs::Entity> m_order{};
+    // A placed node's subtree occupies m_order[position, position + size), tombstones included.
+    struct OrderNode
+    {
+        std::uint32_t position{0};
+        std::uint32_t size{0};
+        ecs::Entity   parent{ecs::NULL_ENTITY}; // (as placed in the order; NULL_ENTITY for roots)
+    };
+
+    std::vector<ecs::Entity> m_order{};           // (NULL_ENTITY marks tombstones until compacted)
+    std::vector<OrderNode>   m_nodes{};           // indexed by entity index
+    std::size_t              m_tombstone_count{0};
+    std::uint32_t            m_batch_depth{0};
+    bool                     m_order_dirty{false}; // (rebuilt by the outermost 'end_batch' or 'get_order')
+
+    std::vector<ecs::Entity>   m_displaced{};        // roots with a parent they aren't placed below yet
+    std::vector<ecs::Entity>   m_stack{};             // (scratch, reused across rebuilds)
+    std::vector<std::uint32_t> m_tombstone_prefix{}; // (scratch, reused across compactions)
+
+    std::vector<Subscription> m_subscriptions{};
+
+    [[nodiscard]] bool is_deferred() const { return m_batch_depth > 0 || m_order_dirty; }
+    [[nodiscard]] bool is_placed(ecs::Entity entity) const;
+    [[nodiscard]] bool should_batch(std::size_t change_count) const;
+
+    OrderNode& get_node(ecs::Entity entity);
+
+    void place(ecs::Entity entity);
+    void remove(ecs::Entity entity);
+    void reparent(ecs::Entity entity);
+    void place_displaced();
+
+    // Moves a placed node's subtree to the end of the order as a root.
+    void detach(ecs::Entity entity);
+    // Moves a root subtree at the end of the order to the end of 'parent''s subtree (unless 'parent' lies in it;
+    // the subtree is then displaced until its parent is moved out).
+    void attach(ecs::Entity entity, ecs::Entity parent);
+
+    void resize_ancestors(ecs::Entity parent, std::int64_t delta);
+    void refresh_positions(std::size_t begin, std::size_t end);
+
+    void rebuild_order();
+    void compact_order();
 };
 }
@@ -1,9 +1,28 @@
 // Copyright © 2024 Jacob Curlin
 
+// Recomputes the world matrices of transforms changed since the system's last run (see
+// ECSManager::mark_changed), along with those of every descendant of a changed entity. Ticks without changes
+// only check the transform array's per-page change ticks. Local matrices are cached on the transforms & only
+// recomposed for changed ones.
+//
+// World matrices are propagated through a flattened copy of the transform hierarchy (see
+// core/transform_table.h), rebuilt once per update after transforms are added or removed, hierarchy
+// components come or go, or nodes are reparented. Rebuilds copy the hierarchy system's maintained order
+// (see core/systems/hierarchy_system.h) in a linear pass; without a hierarchy system every transform is a root.
+
 #pragma once
 
 #include "ecs/system.h"
 #include "core/components/transform.h"
+#include "core/listener_list.h"
+#include "core/transform_table.h"
+
+#include <vector>
+
+namespace cgx::ecs
+{
+class Observer;
+}
 
 namespace cgx::core
 {
@@ -15,19 +34,36 @@ public:
     explicit TransformSystem(ecs::ECSManager* ecs_manager);
     ~TransformSystem() override;
 
-    void initialize(HierarchySystem* hierarchy_system);
-
     void frame_update(float dt) override;
     void fixed_update(float dt) override;
 
     void on_entity_added(ecs::Entity entity) override;
     void on_entity_removed(ecs::Entity entity) override;
 
-    void mark_children_dirty(ecs::Entity parent);
+    // composes the transform's translation, rotation & scale into its local matrix
+    static void update_local_matrix(component::Transform& transform);
 
-    static void update_world_matrix(component::Transform& transform, const glm::mat4& parent_matrix);
+    // the system whose order the table is built from (must outlive this system)
+    void set_hierarchy_system(HierarchySystem* hierarchy_system);
+
+    [[nodiscard]] const TransformTable& get_table() const { return m_table; }
 
 private:
+    ecs::ChangeTick m_last_change_tick{0};
+
     HierarchySystem* m_hierarchy_system{nullptr};
+    TransformTable   m_table{};
+    bool             m_table_stale{true};
+
+    std::vector<std::uint32_t> m_component_indices{}; // (scratch, reused across rebuilds; by entity index)
+
+    ecs::Observer*            m_hierarchy_observer{nullptr}; // entities holding a transform & a hierarchy
+    std::vector<Subscription> m_subscriptions{};
+
+    // the transform of a table row, through the row's cached component index
+    component::Transform& get_transform(std::uint32_t row);
+
+    // Refills the table from the hierarchy's order, taking the transforms' cached local matrices.
+    void rebuild_table();
 };
 }
@@ -0,0 +1,65 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements the flattened transform hierarchy the transform system propagates world matrices through: rows of
+// (entity, parent row, local matrix, world matrix) in parallel arrays, ordered so every parent precedes its
+// children. World matrices are then computed in a single linear pass over the rows (world[i] =
+// world[parent[i]] * local[i]), without looking up components or following child lists. Only rows whose local
+// matrix changed, & their descendants, are recomputed.
+
+#pragma once
+
+#include "ecs/common.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cgx::core
+{
+class TransformTable
+{
+public:
+    static constexpr std::uint32_t k_no_parent = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t k_no_row    = std::numeric_limits<std::uint32_t>::max() - 1;
+
+    void clear();
+
+    // Appends a row for 'entity' below 'parent' (a row appended before, or k_no_parent for roots); its world
+    // matrix is computed by the next propagation. 'component_index' is a hint of where the entity's transform
+    // lives in its component array, for writing world matrices back without a lookup.
+    std::uint32_t push(ecs::Entity entity, std::uint32_t parent, const glm::mat4& local_matrix,
+                       std::uint32_t component_index);
+
+    // the row of 'entity', or k_no_row
+    [[nodiscard]] std::uint32_t find_row(ecs::Entity entity) const;
+
+    void set_local_matrix(std::uint32_t row, const glm::mat4& local_matrix);
+
+    // Recomputes the world matrices of rows whose local matrix changed (or that were pushed) since the last
+    // propagation, along with those of their descendants; returns the rows recomputed, in order. Scans from the
+    // first dirty row on (rows before it can't be dirty or below a dirty one); returns at once if none is.
+    const std::vector<std::uint32_t>& propagate();
+
+    [[nodiscard]] std::size_t      size() const { return m_entities.size(); }
+    [[nodiscard]] ecs::Entity      get_entity(const std::uint32_t row) const { return m_entities[row]; }
+    [[nodiscard]] std::uint32_t    get_parent(const std::uint32_t row) const { return m_parents[row]; }
+    [[nodiscard]] const glm::mat4& get_world_matrix(const std::uint32_t row) const { return m_world_matrices[row]; }
+
+    [[nodiscard]] std::uint32_t get_component_index(const std::uint32_t row) const { return m_component_indices[row]; }
+    void set_component_index(const std::uint32_t row, const std::uint32_t index) { m_component_indices[row] = index; }
+
+private:
+    std::vector<ecs::Entity>   m_entities{};
+    std::vector<std::uint32_t> m_parents{};
+    std::vector<glm::mat4>     m_local_matrices{};
+    std::vector<glm::mat4>     m_world_matrices{};
+    std::vector<std::uint8_t>  m_dirty{};
+    std::uint32_t              m_first_dirty{k_no_row}; // lowest dirty row (k_no_row: none)
+    std::vector<std::uint32_t> m_component_indices{}; // (hints; stale once the component array reorders)
+
+    std::vector<std::uint32_t> m_rows{};         // indexed by entity index
+    std::vector<std::uint32_t> m_updated_rows{}; // (scratch, reused across propagations)
+};
+}
@@ -6,6 +6,7 @@
 #define GLFW_INCLUDE_NONE
 
 #include "core/common.h"
+#include "core/listener_list.h"
 
 #include <GLFW/glfw3.h>
 #include <functional>
@@ -62,6 +63,8 @@ private:
     MouseButtonCallback m_mouse_button_callback;
     ScrollCallback      m_scroll_callback;
 
+    std::vector<Subscription> m_subscriptions{};
+
     void        setup_glfw_callback() const;
     static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
     static void glfw_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
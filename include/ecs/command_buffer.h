@@ -0,0 +1,138 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements a buffer of deferred structural changes (entity release, component add/remove). Commands are
+// recorded while systems iterate and applied in one batch by 'flush', in recording order. Component data and
+// signatures are updated per command, but system membership is only updated once the whole batch has been
+// applied, against the entities' final signatures; each system receives the entities it gained through a single
+// 'on_entities_added' call. Releasing an entity brings membership up to date first, so systems the entity
+// left earlier in the batch still drop it. The engine's buffer ('ECSManager::get_command_buffer') is flushed at
+// the end of every update pass.
+//
+// Entities are acquired immediately (an entity without components matches no system), so later commands can
+// refer to them. Commands targeting an entity that is no longer valid when the batch is applied (e.g. one
+// released earlier in the same batch) are dropped.
+//
+// Recording is thread-safe (systems scheduled concurrently share the engine's buffer); 'flush' must not run
+// concurrently with recording.
+
+#pragma once
+
+#include "ecs/common.h"
+#include "ecs/ecs_manager.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cgx::ecs
+{
+class IComponentStaging
+{
+public:
+    virtual ~IComponentStaging() = default;
+
+    virtual void add(ECSManager& ecs_manager, Entity entity, std::uint32_t staged_index) = 0;
+    virtual void remove(ECSManager& ecs_manager, Entity entity) = 0;
+    virtual void clear() = 0;
+};
+
+// Holds the component values of pending add commands for component type T.
+template<typename T>
+class ComponentStaging final : public IComponentStaging
+{
+public:
+    std::uint32_t push(T component)
+    {
+        m_components.push_back(std::move(component));
+        return static_cast<std::uint32_t>(m_components.size() - 1);
+    }
+
+    void add(ECSManager& ecs_manager, const Entity entity, const std::uint32_t staged_index) override
+    {
+        ecs_manager.insert_component<T>(entity, std::move(m_components[staged_index]));
+    }
+
+    void remove(ECSManager& ecs_manager, const Entity entity) override
+    {
+        ecs_manager.erase_component<T>(entity);
+    }
+
+    void clear() override
+    {
+        m_components.clear();
+    }
+
+private:
+    std::vector<T> m_components{};
+};
+
+class CommandBuffer
+{
+public:
+    explicit CommandBuffer(ECSManager* ecs_manager);
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&)            = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    [[nodiscard]] Entity acquire_entity() const;
+    void                 release_entity(Entity entity);
+
+    template<typename T>
+    void add_component(const Entity entity, T component)
+    {
+        std::lock_guard lock(m_record_mutex);
+        auto&           staging = get_staging<T>();
+        m_commands.push_back({CommandType::AddComponent, entity, staging.push(std::move(component)), &staging});
+    }
+
+    template<typename T>
+    void remove_component(const Entity entity)
+    {
+        std::lock_guard lock(m_record_mutex);
+        m_commands.push_back({CommandType::RemoveComponent, entity, 0, &get_staging<T>()});
+    }
+
+    // Applies every recorded command, then updates the membership of the systems it changed. Commands
+    // recorded by systems reacting to the batch are applied by the same call.
+    void flush();
+
+    [[nodiscard]] bool empty() const { return m_commands.empty(); }
+
+private:
+    enum class CommandType : std::uint8_t
+    {
+        AddComponent,
+        RemoveComponent,
+        ReleaseEntity
+    };
+
+    struct Command
+    {
+        CommandType        type;
+        Entity             entity;
+        std::uint32_t      staged_index;
+        IComponentStaging* staging;
+    };
+
+    ECSManager* m_ecs_manager;
+
+    std::vector<Command>                                           m_commands{};
+    std::array<std::unique_ptr<IComponentStaging>, MAX_COMPONENTS> m_stagings{}; // indexed by component type
+    mutable std::mutex                                             m_record_mutex{};
+
+    template<typename T>
+    ComponentStaging<T>& get_staging()
+    {
+        auto& staging = m_stagings[m_ecs_manager->get_component_type<T>()];
+        if (!staging) {
+            staging = std::make_unique<ComponentStaging<T>>();
+        }
+        return static_cast<ComponentStaging<T>&>(*staging);
+    }
+
+    void apply_commands();
+    void update_systems() const;
+};
+}
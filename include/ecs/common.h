@@ -9,11 +9,42 @@
 
 namespace cgx::ecs
 {
+// An entity handle packs a slot index (low bits) with the slot's generation (high bits). The generation is
+// bumped whenever the slot is released, so stale handles to a recycled slot are detectably invalid. A slot
+// serves at most 4096 generations: released at the last one, it's retired rather than wrapped back to
+// generation 0 (where handles stale since its first use would validate again), so churning entities slowly
+// consumes the index space (about 4 billion acquisitions in all; see ECSManager::get_retired_entity_count &
+// ECSManager::reclaim_retired_entities).
 using Entity        = std::uint32_t;
 using ComponentType = std::uint8_t;
 
-static constexpr Entity        MAX_ENTITIES   = 5000;
+static constexpr std::uint32_t ENTITY_INDEX_BITS      = 20;
+static constexpr std::uint32_t ENTITY_GENERATION_BITS = 12;
+static constexpr std::uint32_t ENTITY_INDEX_MASK      = (1u << ENTITY_INDEX_BITS) - 1;
+static constexpr std::uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
+static constexpr Entity        MAX_ENTITIES   = 1 << ENTITY_INDEX_BITS; // size of the index space
+static constexpr Entity        NULL_ENTITY    = 0xFFFFFFFF;             // (last index is reserved for it)
 static constexpr ComponentType MAX_COMPONENTS = 32;
 
+constexpr std::uint32_t get_entity_index(const Entity entity)
+{
+    return entity & ENTITY_INDEX_MASK;
+}
+
+constexpr std::uint32_t get_entity_generation(const Entity entity)
+{
+    return entity >> ENTITY_INDEX_BITS;
+}
+
+constexpr Entity make_entity(const std::uint32_t index, const std::uint32_t generation)
+{
+    return (generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS | (index & ENTITY_INDEX_MASK);
+}
+
 using Signature = std::bitset<MAX_COMPONENTS>;
+
+// Monotonic counter stamped onto components as they're added or marked changed; advanced by the ecs manager
+// at every sync point (see ECSManager::get_change_tick).
+using ChangeTick = std::uint32_t;
 }
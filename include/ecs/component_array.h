@@ -1,12 +1,34 @@
 // Copyright © 2024 Jacob Curlin
 
-// Implements a packed array structure for storage/management of a particular component type's data. 
+// Implements a packed array structure for storage/management of a particular component type's data.
+// Entity->index lookups go through a paged sparse array (keyed by entity index), index->entity lookups through
+// a dense list of entity handles kept parallel to the packed component data (a 'sparse set'), so every access
+// is plain array indexing. Comparing the dense handle against the queried one rejects stale handles.
+// Component data lives in fixed-size pages allocated as the array grows, so memory follows the number of
+// live components rather than MAX_ENTITIES, and references stay valid while other components are inserted.
+// Each component carries the change tick at which it was last added or marked changed, and each page the
+// newest tick among its components, so queries for recent changes skip unchanged pages wholesale.
 // reference: https://austinmorlan.com/posts/entity_component_system/
 
 #pragma once
 
 #include "core/common.h"
 #include "ecs/common.h"
+#include "ecs/entity_registry.h"
+#include "ecs/snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 namespace cgx::ecs
 {
@@ -15,74 +37,373 @@ class IComponentArray
 public:
     virtual      ~IComponentArray() = default;
     virtual void entity_destroyed(Entity entity) = 0;
+
+    // Snapshot support (see ecs/snapshot.h). 'is_compatible' checks whether a section saved by 'save'
+    // describes this array's component type; 'is_loadable' additionally checks the whole section against the
+    // snapshot's entities (loaded into 'entities'), of which 'owner_count' have component type 'type' in
+    // their signature. 'load' fills an empty array from a section that passed 'is_loadable'.
+    virtual void               save(SnapshotWriter& writer) const = 0;
+    [[nodiscard]] virtual bool is_compatible(SnapshotReader& reader) const = 0;
+    [[nodiscard]] virtual bool is_loadable(SnapshotReader reader, const EntityRegistry& entities, ComponentType type,
+                                           std::size_t owner_count) const = 0;
+    virtual void               load(SnapshotReader& reader) = 0;
 };
 
 template<typename T>
 class ComponentArray final : public IComponentArray
 {
 public:
-    // Inserts the data of 'component' associated with 'entity' at the back of the array, updating
-    // entity->index and index->entity maps to reflect. Increments array size ('m_size'), effectively
+    static constexpr std::size_t   SPARSE_PAGE_SIZE    = 4096;
+    static constexpr std::size_t   COMPONENT_PAGE_SIZE = 512;
+    static constexpr std::uint32_t INVALID_INDEX       = std::numeric_limits<std::uint32_t>::max();
+
+    // 'change_tick' points to the owning registry's current change tick
+    explicit ComponentArray(const ChangeTick* change_tick)
+        : m_change_tick(change_tick) {}
+
+    ~ComponentArray() override
+    {
+        for (std::size_t i = 0 ; i < m_size ; ++i) {
+            data_ptr(i)->~T();
+        }
+    }
+
+    ComponentArray(const ComponentArray&)            = delete;
+    ComponentArray& operator=(const ComponentArray&) = delete;
+
+    // Inserts the data of 'component' associated with 'entity' at the back of the array, pointing the
+    // entity's sparse slot at the new dense index. Increments array size ('m_size'), effectively
     // incrementing the next insertion index to represent the new back of the array.
     void insert_data(const Entity entity, T component)
     {
-        CGX_ASSERT(
-            m_entity_to_index_map.find(entity) == m_entity_to_index_map.end(),
-            "Component added to same entity more than once.");
+        std::uint32_t& slot = get_or_create_slot(entity);
+        CGX_ASSERT(slot == INVALID_INDEX, "Component added to same entity more than once.");
+
+        if (m_size == m_component_pages.size() * COMPONENT_PAGE_SIZE) {
+            m_component_pages.push_back(std::unique_ptr<ComponentPage>(new ComponentPage)); // (left uninitialized)
+        }
 
-        size_t new_index                 = m_size;
-        m_entity_to_index_map[entity]    = new_index;
-        m_index_to_entity_map[new_index] = entity;
-        m_component_array[new_index]     = component;
+        slot = static_cast<std::uint32_t>(m_size);
+        m_dense_entities.push_back(entity);
+        ::new(static_cast<void*>(data_ptr(m_size))) T(std::move(component));
+        set_change_tick(m_size, *m_change_tick);
         ++m_size;
     }
 
     // Removes the component data associated with 'entity' from the array. Moves the component data
     // currently located at the back of the array to the position of the now-freed data to maintain
-    // a packed structure. Decrements array size and updates entity->index and index->entity maps to reflect.
+    // a packed structure. Decrements array size and updates the sparse slot of the moved entity to reflect.
     void remove_data(const Entity entity)
     {
-        CGX_ASSERT(
-            m_entity_to_index_map.find(entity) != m_entity_to_index_map.end(),
-            "Removing non-existent component.");
-
-        size_t index_of_removed_entity             = m_entity_to_index_map[entity];
-        size_t index_of_last_element               = m_size - 1;
-        m_component_array[index_of_removed_entity] = m_component_array[index_of_last_element];
+        std::uint32_t* slot = find_slot(entity);
+        CGX_ASSERT(owns(slot, entity), "Removing non-existent component.");
 
-        const Entity entity_of_last_element                  = m_index_to_entity_map[index_of_last_element];
-        m_entity_to_index_map[entity_of_last_element]  = index_of_removed_entity;
-        m_index_to_entity_map[index_of_removed_entity] = entity_of_last_element;
-
-        m_entity_to_index_map.erase(entity);
-        m_index_to_entity_map.erase(index_of_last_element);
-
-        --m_size;
+        remove_at(slot);
     }
 
     // Returns the component data associated with 'entity'.
     T& get_data(const Entity entity)
     {
-        CGX_ASSERT(
-            m_entity_to_index_map.find(entity) != m_entity_to_index_map.end(),
-            "Retrieving non-existent component.");
+        const std::uint32_t* slot = find_slot(entity);
+        CGX_ASSERT(owns(slot, entity), "Retrieving non-existent component.");
 
-        return m_component_array[m_entity_to_index_map[entity]];
+        return *data_ptr(*slot);
+    }
+
+    [[nodiscard]] bool contains(const Entity entity) const
+    {
+        return owns(find_slot(entity), entity);
     }
 
     // Checks if 'entity' corresponds to component data in the array, removing it if present.
     void entity_destroyed(const Entity entity) override
     {
-        if (m_entity_to_index_map.find(entity) != m_entity_to_index_map.end()) {
-            remove_data(entity);
+        if (std::uint32_t* slot = find_slot(entity) ; owns(slot, entity)) {
+            remove_at(slot);
+        }
+    }
+
+    // Stamps the component of 'entity' with the current change tick. Safe to call concurrently for distinct
+    // entities.
+    void mark_changed(const Entity entity)
+    {
+        const std::uint32_t* slot = find_slot(entity);
+        CGX_ASSERT(owns(slot, entity), "Marking non-existent component as changed.");
+
+        set_change_tick(*slot, *m_change_tick);
+    }
+
+    void mark_changed_at(const std::size_t index)
+    {
+        set_change_tick(index, *m_change_tick);
+    }
+
+    [[nodiscard]] ChangeTick get_change_tick_at(const std::size_t index) const
+    {
+        return page_of(index).change_ticks[index % COMPONENT_PAGE_SIZE];
+    }
+
+    // Invokes 'func(entity, T&)' for every component added or marked changed at or after tick 'since'.
+    template<typename Func>
+    void each_changed(const ChangeTick since, Func&& func)
+    {
+        for (std::size_t page = 0 ; page * COMPONENT_PAGE_SIZE < m_size ; ++page) {
+            const ComponentPage& component_page = *m_component_pages[page];
+            if (component_page.newest_change_tick.load(std::memory_order_relaxed) < since) {
+                continue;
+            }
+
+            const std::size_t end = std::min(m_size, (page + 1) * COMPONENT_PAGE_SIZE);
+            for (std::size_t i = page * COMPONENT_PAGE_SIZE ; i < end ; ++i) {
+                if (component_page.change_ticks[i % COMPONENT_PAGE_SIZE] >= since) {
+                    func(m_dense_entities[i], *data_ptr(i));
+                }
+            }
+        }
+    }
+
+    // Overrides the raw-bytes snapshot encoding (required for types that aren't trivially copyable).
+    void set_serializer(ComponentSerializer<T> serializer)
+    {
+        m_serializer = std::move(serializer);
+    }
+
+    void save(SnapshotWriter& writer) const override
+    {
+        const bool raw = std::is_trivially_copyable_v<T> && !m_serializer.write;
+        CGX_ASSERT(raw || m_serializer.write, "Saving component type that is neither trivially copyable nor given a serializer.");
+
+        writer.write_string(typeid(T).name());
+        writer.write(static_cast<std::uint32_t>(sizeof(T)));
+        writer.write(static_cast<std::uint8_t>(raw));
+        writer.write_vector(m_dense_entities);
+
+        if (raw) {
+            for (std::size_t begin = 0 ; begin < m_size ; begin += COMPONENT_PAGE_SIZE) {
+                writer.write_bytes(data_ptr(begin), std::min(COMPONENT_PAGE_SIZE, m_size - begin) * sizeof(T));
+            }
+            return;
+        }
+        for (std::size_t i = 0 ; i < m_size ; ++i) {
+            m_serializer.write(*data_ptr(i), writer);
+        }
+    }
+
+    [[nodiscard]] bool is_compatible(SnapshotReader& reader) const override
+    {
+        const std::string name = reader.read_string();
+        const auto        size = reader.read<std::uint32_t>();
+        return !reader.has_failed() && name == typeid(T).name() && size == sizeof(T);
+    }
+
+    [[nodiscard]] bool is_loadable(SnapshotReader reader, const EntityRegistry& entities, const ComponentType type,
+                                   const std::size_t owner_count) const override
+    {
+        if (!is_compatible(reader)) {
+            return false;
+        }
+        const bool raw    = reader.read<std::uint8_t>() != 0;
+        auto       owners = reader.read_vector<Entity>();
+        if (reader.has_failed() || owners.size() != owner_count) {
+            return false;
+        }
+
+        // each entity live & holding this type (so with 'owner_count' distinct ones, exactly its owners)
+        for (const auto entity : owners) {
+            if (!entities.is_valid(entity) || !entities.get_signature(entity).test(type)) {
+                return false;
+            }
+        }
+        std::sort(owners.begin(), owners.end());
+        if (std::adjacent_find(owners.begin(), owners.end()) != owners.end()) {
+            return false;
+        }
+
+        if (raw) {
+            return std::is_trivially_copyable_v<T> && reader.get_remaining() == owner_count * sizeof(T);
+        }
+        if (!m_serializer.read) {
+            return false;
+        }
+        for (std::size_t i = 0 ; i < owner_count && !reader.has_failed() ; ++i) {
+            m_serializer.read(reader); // (decoded & dropped; only the reads are checked)
+        }
+        return reader.is_complete();
+    }
+
+    void load(SnapshotReader& reader) override
+    {
+        const bool compatible = is_compatible(reader);
+        CGX_ASSERT(compatible, "Loading snapshot section of a different component type.");
+        CGX_ASSERT(m_size == 0, "Loading snapshot into non-empty component array.");
+
+        const bool raw   = reader.read<std::uint8_t>() != 0;
+        m_dense_entities = reader.read_vector<Entity>();
+
+        const std::size_t count = m_dense_entities.size();
+        while (m_component_pages.size() * COMPONENT_PAGE_SIZE < count) {
+            m_component_pages.push_back(std::unique_ptr<ComponentPage>(new ComponentPage));
+        }
+        for (std::size_t i = 0 ; i < count ; ++i) {
+            get_or_create_slot(m_dense_entities[i]) = static_cast<std::uint32_t>(i);
+        }
+
+        if (raw) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                for (std::size_t begin = 0 ; begin < count ; begin += COMPONENT_PAGE_SIZE) {
+                    const std::size_t size = std::min(COMPONENT_PAGE_SIZE, count - begin) * sizeof(T);
+                    std::memcpy(page_of(begin).storage, reader.read_bytes(size), size);
+                }
+            }
+            else {
+                CGX_ASSERT(false, "Raw snapshot data for component type that isn't trivially copyable.");
+            }
+        }
+        else {
+            CGX_ASSERT(m_serializer.read, "Loading serialized component type without a serializer.");
+            for (std::size_t i = 0 ; i < count ; ++i) {
+                ::new(static_cast<void*>(data_ptr(i))) T(m_serializer.read(reader));
+            }
+        }
+
+        m_size = count;
+        for (std::size_t i = 0 ; i < count ; ++i) {
+            set_change_tick(i, *m_change_tick);
         }
     }
 
+    // Dense (packed) access, for systems that walk every component of this type. The entity at
+    // get_entities()[i] owns the component at get_data_at(i), for i in [0, size()).
+    [[nodiscard]] std::size_t                size() const { return m_size; }
+    [[nodiscard]] const std::vector<Entity>& get_entities() const { return m_dense_entities; }
+
+    T& get_data_at(const std::size_t index)
+    {
+        return *data_ptr(index);
+    }
+
+    [[nodiscard]] std::size_t get_index(const Entity entity) const
+    {
+        const std::uint32_t* slot = find_slot(entity);
+        CGX_ASSERT(owns(slot, entity), "Retrieving index of non-existent component.");
+
+        return *slot;
+    }
+
+    // Exchanges the dense positions of two components (data, owning entities & sparse slots). Used by
+    // groups to keep the components of matching entities packed at the front of the array.
+    void swap_positions(const std::size_t lhs, const std::size_t rhs)
+    {
+        if (lhs == rhs) {
+            return;
+        }
+        std::swap(*data_ptr(lhs), *data_ptr(rhs));
+        std::swap(m_dense_entities[lhs], m_dense_entities[rhs]);
+
+        const ChangeTick lhs_tick = get_change_tick_at(lhs);
+        set_change_tick(lhs, get_change_tick_at(rhs));
+        set_change_tick(rhs, lhs_tick);
+
+        *find_slot(m_dense_entities[lhs]) = static_cast<std::uint32_t>(lhs);
+        *find_slot(m_dense_entities[rhs]) = static_cast<std::uint32_t>(rhs);
+    }
+
 private:
-    std::array<T, MAX_ENTITIES>        m_component_array;
-    std::unordered_map<Entity, size_t> m_entity_to_index_map;
-    std::unordered_map<size_t, Entity> m_index_to_entity_map;
+    using SparsePage = std::array<std::uint32_t, SPARSE_PAGE_SIZE>;
+
+    // Uninitialized storage for COMPONENT_PAGE_SIZE components; slots are constructed on insert. Aligned (& so
+    // padded) to whole cache lines, so threads writing distinct pages never share a line.
+    struct alignas(std::max<std::size_t>(64, alignof(T))) ComponentPage
+    {
+        alignas(T) std::byte    storage[sizeof(T) * COMPONENT_PAGE_SIZE];
+        ChangeTick              change_ticks[COMPONENT_PAGE_SIZE];
+        std::atomic<ChangeTick> newest_change_tick{0};
+    };
+
+    const ChangeTick*      m_change_tick;
+    ComponentSerializer<T> m_serializer{};
+
+    std::vector<std::unique_ptr<ComponentPage>> m_component_pages{};
+    std::vector<Entity>                         m_dense_entities{};
+    std::vector<std::unique_ptr<SparsePage>>    m_sparse_pages{};
 
     size_t m_size = 0;
+
+    void remove_at(std::uint32_t* slot)
+    {
+        const std::uint32_t index_of_removed_entity = *slot;
+        const std::size_t   index_of_last_element   = m_size - 1;
+
+        if (index_of_removed_entity != index_of_last_element) {
+            const Entity entity_of_last_element = m_dense_entities[index_of_last_element];
+
+            *data_ptr(index_of_removed_entity)        = std::move(*data_ptr(index_of_last_element));
+            m_dense_entities[index_of_removed_entity] = entity_of_last_element;
+            *find_slot(entity_of_last_element)        = index_of_removed_entity;
+            set_change_tick(index_of_removed_entity, get_change_tick_at(index_of_last_element));
+        }
+
+        data_ptr(index_of_last_element)->~T();
+
+        *slot = INVALID_INDEX;
+        m_dense_entities.pop_back();
+        --m_size;
+
+        // keep at most one spare page past the back of the array
+        const std::size_t pages_in_use = (m_size + COMPONENT_PAGE_SIZE - 1) / COMPONENT_PAGE_SIZE;
+        while (m_component_pages.size() > pages_in_use + 1) {
+            m_component_pages.pop_back();
+        }
+    }
+
+    ComponentPage& page_of(const std::size_t index) const
+    {
+        return *m_component_pages[index / COMPONENT_PAGE_SIZE];
+    }
+
+    void set_change_tick(const std::size_t index, const ChangeTick tick)
+    {
+        ComponentPage& page = page_of(index);
+        page.change_ticks[index % COMPONENT_PAGE_SIZE] = tick;
+
+        // ticks only grow, so concurrent stamps of the current tick never lower the page's newest tick
+        if (page.newest_change_tick.load(std::memory_order_relaxed) < tick) {
+            page.newest_change_tick.store(tick, std::memory_order_relaxed);
+        }
+    }
+
+    T* data_ptr(const std::size_t index) const
+    {
+        std::byte* page = m_component_pages[index / COMPONENT_PAGE_SIZE]->storage;
+        return std::launder(reinterpret_cast<T*>(page) + index % COMPONENT_PAGE_SIZE);
+    }
+
+    // true if 'slot' (looked up by the index of 'entity') holds component data of that exact handle
+    bool owns(const std::uint32_t* slot, const Entity entity) const
+    {
+        return slot != nullptr && *slot != INVALID_INDEX && m_dense_entities[*slot] == entity;
+    }
+
+    std::uint32_t* find_slot(const Entity entity) const
+    {
+        const std::size_t page = get_entity_index(entity) / SPARSE_PAGE_SIZE;
+        if (page >= m_sparse_pages.size() || !m_sparse_pages[page]) {
+            return nullptr;
+        }
+        return &(*m_sparse_pages[page])[get_entity_index(entity) % SPARSE_PAGE_SIZE];
+    }
+
+    std::uint32_t& get_or_create_slot(const Entity entity)
+    {
+        const std::size_t page = get_entity_index(entity) / SPARSE_PAGE_SIZE;
+        if (page >= m_sparse_pages.size()) {
+            m_sparse_pages.resize(page + 1);
+        }
+        if (!m_sparse_pages[page]) {
+            m_sparse_pages[page] = std::make_unique<SparsePage>();
+            m_sparse_pages[page]->fill(INVALID_INDEX);
+        }
+        return (*m_sparse_pages[page])[get_entity_index(entity) % SPARSE_PAGE_SIZE];
+    }
 };
 }
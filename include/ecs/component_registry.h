@@ -10,10 +10,33 @@
 #include "../core/event_handler.h"
 #include "utility/logging.h"
 
-#include <unordered_map>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace cgx::ecs
 {
+// Assigns each component type a process-wide index the first time it is used, so registries can resolve
+// per-type data with a single indexed load rather than hashing 'typeid' names.
+class ComponentFamily
+{
+public:
+    template<typename T>
+    static std::size_t get()
+    {
+        static const std::size_t family = next();
+        return family;
+    }
+
+private:
+    static std::size_t next()
+    {
+        static std::atomic<std::size_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
 class ComponentRegistry
 {
 public:
@@ -23,40 +46,31 @@ public:
     template<typename T>
     void register_component()
     {
-        const char* type_name = typeid(T).name();
-
-        CGX_ASSERT(
-            m_component_types.find(type_name) == m_component_types.end(),
-            "Registering component type more than once.");
+        const std::size_t family = ComponentFamily::get<T>();
+        if (family >= m_slots.size()) {
+            m_slots.resize(family + 1);
+        }
 
-        ComponentType type_id = m_next_component_type;
-        m_component_types.insert({type_name, type_id});
+        CGX_ASSERT(m_slots[family].array == nullptr, "Registering component type more than once.");
+        CGX_ASSERT(m_component_arrays.size() < MAX_COMPONENTS, "Registering more than MAX_COMPONENTS component types.");
 
-        auto component_array = std::make_shared<ComponentArray<T>>();
+        auto component_array = std::make_unique<ComponentArray<T>>(&m_change_tick);
 
-        m_component_arrays.insert({type_name, component_array});
-
-        m_type_id_to_arrays.insert({type_id, component_array});
-
-        ++m_next_component_type;
+        m_slots[family].type  = static_cast<ComponentType>(m_component_arrays.size());
+        m_slots[family].array = component_array.get();
+        m_component_arrays.push_back(std::move(component_array));
     }
 
     template<typename T>
-    ComponentType get_component_type()
+    [[nodiscard]] ComponentType get_component_type() const
     {
-        const char* type_name = typeid(T).name();
-
-        CGX_ASSERT(
-            m_component_types.find(type_name) != m_component_types.end(),
-            "Component not registered before use.");
-
-        return m_component_types[type_name];
+        return get_slot<T>().type;
     }
 
     template<typename T>
     void add_component(Entity entity, T component)
     {
-        get_component_array<T>()->insert_data(entity, component);
+        get_component_array<T>()->insert_data(entity, std::move(component));
     }
 
     template<typename T>
@@ -71,24 +85,45 @@ public:
         return get_component_array<T>()->get_data(entity);
     }
 
-    void on_entity_released(Entity entity) const;
+    template<typename T>
+    [[nodiscard]] ComponentArray<T>* get_component_array() const
+    {
+        return static_cast<ComponentArray<T>*>(get_slot<T>().array);
+    }
+
+    // Destroys the released entity's components, visiting only the arrays its signature refers to.
+    void on_entity_released(Entity entity, const Signature& signature) const;
+
+    // Snapshot support; every registered component type gets one section, in registration order.
+    // 'is_compatible' checks the sections' types only; 'is_loadable' checks the whole snapshot against its
+    // entities (already loaded into 'entities'), which 'load' then expects.
+    void               save(SnapshotWriter& writer) const;
+    [[nodiscard]] bool is_compatible(SnapshotReader reader) const;
+    [[nodiscard]] bool is_loadable(SnapshotReader reader, const EntityRegistry& entities) const;
+    void               load(SnapshotReader& reader);
+
+    [[nodiscard]] ChangeTick get_change_tick() const { return m_change_tick; }
+    void                     advance_change_tick() { ++m_change_tick; }
 
 private:
-    std::unordered_map<const char*, ComponentType>                      m_component_types{};
-    std::unordered_map<const char*, std::shared_ptr<IComponentArray>>   m_component_arrays{};
-    std::unordered_map<ComponentType, std::shared_ptr<IComponentArray>> m_type_id_to_arrays{};
-    ComponentType                                                       m_next_component_type{};
+    struct ComponentSlot
+    {
+        ComponentType    type{std::numeric_limits<ComponentType>::max()};
+        IComponentArray* array{nullptr};
+    };
+
+    std::vector<ComponentSlot>                    m_slots{};            // indexed by component family
+    std::vector<std::unique_ptr<IComponentArray>> m_component_arrays{}; // indexed by component type
+    ChangeTick                                    m_change_tick{1};      // (0: before any change)
 
     template<typename T>
-    std::shared_ptr<ComponentArray<T>> get_component_array()
+    const ComponentSlot& get_slot() const
     {
-        const char* type_name = typeid(T).name();
+        const std::size_t family = ComponentFamily::get<T>();
 
-        CGX_ASSERT(
-            m_component_types.find(type_name) != m_component_types.end(),
-            "Component not registered before use.");
+        CGX_ASSERT(family < m_slots.size() && m_slots[family].array != nullptr, "Component not registered before use.");
 
-        return std::static_pointer_cast<ComponentArray<T>>(m_component_arrays[type_name]);
+        return m_slots[family];
     }
 };
 }
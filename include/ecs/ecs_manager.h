@@ -4,30 +4,121 @@
 
 #include "ecs/entity_registry.h"
 #include "ecs/component_registry.h"
+#include "ecs/group.h"
+#include "ecs/observer.h"
 #include "ecs/system_registry.h"
+#include "ecs/view.h"
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+namespace cgx::core
+{
+class JobSystem;
+}
 
 namespace cgx::ecs
 {
+class CommandBuffer;
+template<typename T>
+class ComponentStaging;
 
 class ECSManager
 {
 public:
-    ECSManager();
+    // 'job_system' runs systems concurrently where their declared component access allows, & is available to
+    // systems for their own parallel work.
+    explicit ECSManager(core::JobSystem* job_system);
     ~ECSManager();
 
     void frame_update(float dt) const;
     void fixed_update(float dt) const;
 
+    // Buffer for structural changes recorded while systems iterate; flushed after each update pass.
+    CommandBuffer& get_command_buffer() const;
+
+    [[nodiscard]] core::JobSystem* get_job_system() const { return m_job_system; }
+
     [[nodiscard]] Entity acquire_entity() const
     {
         return m_entity_registry->acquire_entity();
     }
 
+    [[nodiscard]] std::vector<Entity> acquire_entities(const std::size_t count) const
+    {
+        std::vector<Entity> entities;
+        entities.reserve(count);
+        for (std::size_t i = 0 ; i < count ; ++i) {
+            entities.push_back(m_entity_registry->acquire_entity());
+        }
+        return entities;
+    }
+
+    // True while 'entity' refers to a live entity; handles to released entities become invalid.
+    [[nodiscard]] bool is_valid(const Entity entity) const
+    {
+        return m_entity_registry->is_valid(entity);
+    }
+
+    // Entity slots retired after their last generation (see ecs/common.h); each shrinks the index space for
+    // good unless reclaimed, so long-running worlds churning entities should keep an eye on it.
+    [[nodiscard]] std::uint32_t get_retired_entity_count() const
+    {
+        return m_entity_registry->get_retired_count();
+    }
+
+    // Makes retired slots reusable (at generation 0). Handles to them from before retirement would validate
+    // again, so this needs a world without entities whose old handles aren't kept elsewhere either (e.g. between
+    // scenes); while entities are live, it does nothing & returns false.
+    bool reclaim_retired_entities() const
+    {
+        if (m_entity_registry->get_active_entity_count() != 0) {
+            CGX_ERROR("ECSManager: retired entity slots can only be reclaimed in a world without entities");
+            return false;
+        }
+        m_entity_registry->reclaim_retired();
+        return true;
+    }
+
     void release_entity(const Entity entity) const
     {
-        m_system_registry->on_entity_released(entity);
+        const auto signature = m_entity_registry->get_signature(entity);
+        for (const auto& group : m_groups) {
+            if (group->matches(signature)) {
+                group->on_entity_unmatched(entity);
+            }
+        }
+
+        notify_observers(entity, signature, Signature{});
+
+        m_system_registry->update_membership(); // (systems may still read the entity's components)
         m_entity_registry->release_entity(entity);
-        m_component_registry->on_entity_released(entity);
+        m_component_registry->on_entity_released(entity, signature);
+    }
+
+    // Releases every entity in 'entities' (distinct, live), notifying each system once with every entity it lost.
+    void release_entities(const std::vector<Entity>& entities) const
+    {
+        std::vector<Signature> signatures;
+        signatures.reserve(entities.size());
+        for (const auto entity : entities) {
+            const auto signature = m_entity_registry->get_signature(entity);
+            for (const auto& group : m_groups) {
+                if (group->matches(signature)) {
+                    group->on_entity_unmatched(entity);
+                }
+            }
+            notify_observers(entity, signature, Signature{});
+            signatures.push_back(signature);
+        }
+
+        m_system_registry->update_membership();
+
+        for (std::size_t i = 0 ; i < entities.size() ; ++i) {
+            m_entity_registry->release_entity(entities[i]);
+            m_component_registry->on_entity_released(entities[i], signatures[i]);
+        }
     }
 
     template<typename T>
@@ -39,25 +130,34 @@ public:
     template<typename T>
     void add_component(const Entity entity, T component)
     {
-        m_component_registry->add_component<T>(entity, component);
+        insert_component<T>(entity, std::move(component));
+        m_system_registry->update_membership();
+    }
 
-        auto signature = m_entity_registry->get_signature(entity);
-        signature.set(m_component_registry->get_component_type<T>(), true);
-        m_entity_registry->set_signature(entity, signature);
+    // Adds every component in 'components' to 'entity', writing its signature and notifying systems once.
+    template<typename... Ts>
+    void add_components(const Entity entity, Ts... components)
+    {
+        insert_components<Ts...>(entity, std::move(components)...);
+        m_system_registry->update_membership();
+    }
 
-        m_system_registry->on_entity_updated(entity, signature);
+    // Adds a copy of each 'prototype' component to every entity in 'entities', then notifies each system once
+    // with every entity it gained.
+    template<typename... Ts>
+    void add_components(const std::vector<Entity>& entities, const Ts&... prototype)
+    {
+        for (const auto entity : entities) {
+            insert_components<Ts...>(entity, prototype...);
+        }
+        m_system_registry->update_membership();
     }
 
     template<typename T>
     void remove_component(const Entity entity) const
     {
-        m_component_registry->remove_component<T>(entity);
-
-        auto signature = m_entity_registry->get_signature(entity);
-        signature.set(m_component_registry->get_component_type<T>(), false);
-        m_entity_registry->set_signature(entity, signature);
-
-        m_system_registry->on_entity_updated(entity, signature);
+        erase_component<T>(entity);
+        m_system_registry->update_membership();
     }
 
     template<typename T>
@@ -66,6 +166,29 @@ public:
         return m_component_registry->get_component<T>(entity);
     }
 
+    // Stamps the T component of 'entity' with the current change tick, for systems consuming changes through
+    // 'ComponentArray::each_changed'. Safe to call concurrently for distinct entities.
+    template<typename T>
+    void mark_changed(const Entity entity) const
+    {
+        m_component_registry->get_component_array<T>()->mark_changed(entity);
+    }
+
+    // The tick components are currently stamped with when added or marked changed; advanced at every sync
+    // point. A system recording this tick before consuming changes sees every later change on its next run
+    // through 'each_changed(recorded_tick, ...)' (along with changes made during the recorded tick itself).
+    [[nodiscard]] ChangeTick get_change_tick() const
+    {
+        return m_component_registry->get_change_tick();
+    }
+
+    // Direct access to the packed storage of component type T, for walking every instance in order.
+    template<typename T>
+    ComponentArray<T>& get_component_array() const
+    {
+        return *m_component_registry->get_component_array<T>();
+    }
+
     template<typename T>
     [[nodiscard]] ComponentType get_component_type() const
     {
@@ -79,6 +202,94 @@ public:
         return signature.test(m_component_registry->get_component_type<T>());
     }
 
+    // Registers an owning group over component types Ts (see ecs/group.h). Entities that already hold
+    // every component are packed into the group immediately; later ones are packed as they match.
+    template<typename... Ts>
+    Group<Ts...>& register_group()
+    {
+        Signature signature;
+        (signature.set(m_component_registry->get_component_type<Ts>()), ...);
+
+        auto  group     = std::make_unique<Group<Ts...>>(signature, get_component_array<Ts>()...);
+        auto& group_ref = *group;
+
+        for (const auto type : {m_component_registry->get_component_type<Ts>()...}) {
+            CGX_ASSERT(m_owning_groups[type] == nullptr, "Component type already owned by another group.");
+            m_owning_groups[type] = group.get();
+        }
+        m_groups.push_back(std::move(group));
+
+        const auto entities = m_entity_registry->get_active_entities();
+        for (const auto entity : entities) {
+            if (group_ref.matches(m_entity_registry->get_signature(entity))) {
+                group_ref.on_entity_matched(entity);
+            }
+        }
+
+        return group_ref;
+    }
+
+    template<typename... Ts>
+    Group<Ts...>& get_group() const
+    {
+        using First = std::tuple_element_t<0, std::tuple<Ts...>>;
+
+        auto* group = dynamic_cast<Group<Ts...>*>(m_owning_groups[m_component_registry->get_component_type<First>()]);
+        CGX_ASSERT(group != nullptr, "Group used before being registered.");
+
+        return *group;
+    }
+
+    // Registers an observer over the entities holding every type in 'include' & none in 'exclude' (see
+    // ecs/observer.h). Entities already matching are reported as matched.
+    Observer& register_observer(const Signature include, const Signature exclude)
+    {
+        auto& observer = *m_observers.emplace_back(std::make_unique<Observer>(include, exclude));
+
+        const Signature types = include | exclude;
+        for (ComponentType type = 0 ; type < MAX_COMPONENTS ; ++type) {
+            if (types.test(type)) {
+                m_observers_by_type[type].push_back(&observer);
+            }
+        }
+
+        for (const auto entity : m_entity_registry->get_active_entities()) {
+            if (observer.matches(m_entity_registry->get_signature(entity))) {
+                observer.on_entity_matched(entity);
+            }
+        }
+
+        return observer;
+    }
+
+    template<typename... Ts>
+    Observer& register_observer(const Signature exclude = {})
+    {
+        Signature include;
+        (include.set(m_component_registry->get_component_type<Ts>()), ...);
+        return register_observer(include, exclude);
+    }
+
+    // Returns a view over every entity holding all of Ts (see ecs/view.h). Backed by the owning group
+    // over exactly Ts when one is registered.
+    template<typename... Ts>
+    View<Ts...> view() const
+    {
+        const IGroup* group = nullptr;
+        if constexpr (sizeof...(Ts) > 1) {
+            using First = std::tuple_element_t<0, std::tuple<Ts...>>;
+
+            Signature signature;
+            (signature.set(m_component_registry->get_component_type<Ts>()), ...);
+
+            const IGroup* owner = m_owning_groups[m_component_registry->get_component_type<First>()];
+            if (owner != nullptr && owner->get_signature() == signature) {
+                group = owner;
+            }
+        }
+        return View<Ts...>(get_component_array<Ts>()..., group);
+    }
+
     template<typename T>
     std::shared_ptr<T> register_system()
     {
@@ -91,9 +302,135 @@ public:
         m_system_registry->set_signature<T>(signature);
     }
 
+    // Declares the component types system T reads & writes, letting it run concurrently with systems it
+    // doesn't conflict with (see ecs/system_registry.h).
+    template<typename T>
+    void set_system_access(const Signature reads, const Signature writes) const
+    {
+        m_system_registry->set_access<T>(reads, writes);
+    }
+
+    [[nodiscard]] std::vector<SystemTiming> get_system_timings() const
+    {
+        return m_system_registry->get_timings();
+    }
+
+    // Writes every entity & component to a binary snapshot file (see ecs/snapshot.h).
+    bool save_snapshot(const std::filesystem::path& path) const;
+
+    // Restores a snapshot into this world, which must hold no entities & have the snapshot's component types
+    // registered (in the same order, with serializers where they were used for saving). Groups, observers &
+    // systems are repopulated with the loaded entities, which are all stamped as changed. Entity handles are
+    // preserved, so components referring to other entities stay valid. The whole file is checked before the
+    // world is touched; a missing, truncated or inconsistent file leaves the world unchanged & returns false.
+    bool load_snapshot(const std::filesystem::path& path);
+
+    // Sets the snapshot encoding of component type T; required for types that aren't trivially copyable.
+    template<typename T>
+    void set_component_serializer(ComponentSerializer<T> serializer) const
+    {
+        get_component_array<T>().set_serializer(std::move(serializer));
+    }
+
 private:
+    friend class CommandBuffer;
+    template<typename T>
+    friend class ComponentStaging;
+
     std::unique_ptr<EntityRegistry>    m_entity_registry;
     std::unique_ptr<ComponentRegistry> m_component_registry;
     std::unique_ptr<SystemRegistry>    m_system_registry;
+    core::JobSystem*                   m_job_system;
+
+    std::vector<std::unique_ptr<IGroup>> m_groups{};
+    std::array<IGroup*, MAX_COMPONENTS>  m_owning_groups{}; // indexed by component type
+
+    std::unique_ptr<CommandBuffer> m_command_buffer;
+
+    std::vector<std::unique_ptr<Observer>>             m_observers{};
+    std::array<std::vector<Observer*>, MAX_COMPONENTS> m_observers_by_type{}; // indexed by component type
+
+    // Re-evaluates the observers referring to any type that differs between the two signatures.
+    void notify_observers(const Entity entity, const Signature& old_signature, const Signature& new_signature) const
+    {
+        const Signature changed = old_signature ^ new_signature;
+        if (changed.none()) {
+            return;
+        }
+
+        for (ComponentType type = 0 ; type < MAX_COMPONENTS ; ++type) {
+            if (!changed.test(type)) {
+                continue;
+            }
+            // types below 'type' that changed; observers referring to one of them were handled already
+            const Signature handled = changed & Signature((1ull << type) - 1);
+
+            for (Observer* observer : m_observers_by_type[type]) {
+                if (((observer->get_include() | observer->get_exclude()) & handled).any()) {
+                    continue;
+                }
+
+                const bool matched = observer->matches(old_signature);
+                if (const bool matches = observer->matches(new_signature) ; matches != matched) {
+                    matches ? observer->on_entity_matched(entity) : observer->on_entity_unmatched(entity);
+                }
+            }
+        }
+    }
+
+    // Structural changes without system notification (recorded by the systems' observers until
+    // 'SystemRegistry::update_membership').
+    template<typename T>
+    void insert_component(const Entity entity, T component)
+    {
+        m_component_registry->add_component<T>(entity, std::move(component));
+
+        const auto type          = m_component_registry->get_component_type<T>();
+        const auto old_signature = m_entity_registry->get_signature(entity);
+        auto       signature     = old_signature;
+        signature.set(type, true);
+        m_entity_registry->set_signature(entity, signature);
+
+        if (IGroup* group = m_owning_groups[type] ; group && group->matches(signature)) {
+            group->on_entity_matched(entity);
+        }
+        notify_observers(entity, old_signature, signature);
+    }
+
+    template<typename... Ts>
+    void insert_components(const Entity entity, Ts... components)
+    {
+        (m_component_registry->add_component<Ts>(entity, std::move(components)), ...);
+
+        const auto old_signature = m_entity_registry->get_signature(entity);
+        auto       signature     = old_signature;
+        (signature.set(m_component_registry->get_component_type<Ts>(), true), ...);
+        m_entity_registry->set_signature(entity, signature);
+
+        for (const auto& group : m_groups) {
+            if (!group->matches(old_signature) && group->matches(signature)) {
+                group->on_entity_matched(entity);
+            }
+        }
+        notify_observers(entity, old_signature, signature);
+    }
+
+    template<typename T>
+    void erase_component(const Entity entity) const
+    {
+        const auto type          = m_component_registry->get_component_type<T>();
+        const auto old_signature = m_entity_registry->get_signature(entity);
+
+        if (IGroup* group = m_owning_groups[type] ; group && group->matches(old_signature)) {
+            group->on_entity_unmatched(entity);
+        }
+
+        m_component_registry->remove_component<T>(entity);
+
+        auto signature = old_signature;
+        signature.set(type, false);
+        m_entity_registry->set_signature(entity, signature);
+        notify_observers(entity, old_signature, signature);
+    }
 };
 }
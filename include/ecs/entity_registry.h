@@ -3,9 +3,8 @@
 #pragma once
 
 #include "ecs/common.h"
-#include <array>
+#include "ecs/snapshot.h"
 #include <bitset>
-#include <queue>
 #include <vector>
 
 namespace cgx::ecs
@@ -19,15 +18,36 @@ public:
     Entity acquire_entity();
     void   release_entity(Entity entity);
 
+    // True while 'entity' refers to a live slot of the same generation.
+    [[nodiscard]] bool is_valid(Entity entity) const;
+
     void      set_signature(Entity entity, Signature signature);
-    Signature get_signature(Entity entity);
+    Signature get_signature(Entity entity) const;
 
     [[nodiscard]] std::vector<Entity> get_active_entities() const;
+    [[nodiscard]] std::uint32_t       get_active_entity_count() const { return m_active_entity_count; }
 
-private:
-    std::queue<Entity>                  m_available_entities{};
-    std::array<Signature, MAX_ENTITIES> m_signatures{};
+    // Slots retired after their last generation (see ecs/common.h). 'reclaim_retired' returns them to the
+    // free-list at generation 0; handles to them from before retirement would validate again, so no such handle
+    // may be held anywhere.
+    [[nodiscard]] std::uint32_t get_retired_count() const { return m_retired_count; }
+    void                        reclaim_retired();
 
-    uint32_t m_active_entity_count{0};
+    // Snapshot support; 'load' replaces every slot (live & released) with the snapshot's. A truncated section,
+    // or one whose released slots don't form a single free-list, leaves the registry untouched & returns false.
+    void               save(SnapshotWriter& writer) const;
+    [[nodiscard]] bool load(SnapshotReader& reader);
+
+private:
+    // Indexed by entity index. A live slot holds its entity's current handle; a released slot holds its
+    // next generation, with the index bits linking to the previously released slot (an implicit LIFO
+    // free-list headed by 'm_free_head'), so the most recently freed, cache-warm slot is reused first. A slot
+    // released at its last generation is retired: it holds NULL_ENTITY & is never reused (see ecs/common.h).
+    std::vector<Entity>    m_handles{};
+    std::vector<Signature> m_signatures{};
+
+    std::uint32_t m_free_head{ENTITY_INDEX_MASK}; // ENTITY_INDEX_MASK = empty list
+    uint32_t      m_active_entity_count{0};
+    std::uint32_t m_retired_count{0};
 };
 }
@@ -0,0 +1,103 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements 'owning' groups over a set of component types. Entities holding every component of the group
+// are kept packed at the front of each owned component array, in the same order, so the group's components
+// form parallel contiguous columns: index i of every column belongs to the same entity. Iterating a group
+// therefore streams linearly through memory (like an archetype chunk) without any per-entity lookups.
+// A component type can be owned by at most one group. Adding or removing an owned component may reorder
+// the owned arrays, so references to owned components shouldn't be held across such changes.
+// reference: https://skypjack.github.io/2019-04-12-entt-tips-and-tricks-part-1/
+
+#pragma once
+
+#include "ecs/common.h"
+#include "ecs/component_array.h"
+
+#include <tuple>
+
+namespace cgx::ecs
+{
+class IGroup
+{
+public:
+    explicit IGroup(const Signature signature)
+        : m_signature(signature) {}
+
+    virtual ~IGroup() = default;
+
+    // called once 'entity' holds every component of the group
+    virtual void on_entity_matched(Entity entity) = 0;
+
+    // called while 'entity' still holds every component of the group, before one of them is removed
+    virtual void on_entity_unmatched(Entity entity) = 0;
+
+    [[nodiscard]] const Signature& get_signature() const { return m_signature; }
+    [[nodiscard]] std::size_t      size() const { return m_size; }
+
+    [[nodiscard]] bool matches(const Signature& signature) const
+    {
+        return (signature & m_signature) == m_signature;
+    }
+
+protected:
+    Signature   m_signature;
+    std::size_t m_size{0};
+};
+
+template<typename... Ts>
+class Group final : public IGroup
+{
+public:
+    static_assert(sizeof...(Ts) > 1, "A group must own at least two component types.");
+
+    Group(const Signature signature, ComponentArray<Ts>&... arrays)
+        : IGroup(signature)
+        , m_arrays(&arrays...) {}
+
+    // Swaps the components of 'entity' to the back of the packed group range in every owned array.
+    void on_entity_matched(const Entity entity) override
+    {
+        (pack<Ts>(entity, m_size), ...);
+        ++m_size;
+    }
+
+    // Swaps the components of 'entity' to the last position of the group range, then shrinks the range
+    // to exclude it.
+    void on_entity_unmatched(const Entity entity) override
+    {
+        --m_size;
+        (pack<Ts>(entity, m_size), ...);
+    }
+
+    // Invokes 'func(entity, Ts&...)' for every entity of the group, walking the owned arrays in lockstep.
+    template<typename Func>
+    void each(Func&& func)
+    {
+        const auto& entities = std::get<0>(m_arrays)->get_entities();
+        for (std::size_t i = 0 ; i < m_size ; ++i) {
+            func(entities[i], std::get<ComponentArray<Ts>*>(m_arrays)->get_data_at(i)...);
+        }
+    }
+
+    [[nodiscard]] Entity get_entity(const std::size_t index) const
+    {
+        return std::get<0>(m_arrays)->get_entities()[index];
+    }
+
+    template<typename T>
+    T& get(const std::size_t index)
+    {
+        return std::get<ComponentArray<T>*>(m_arrays)->get_data_at(index);
+    }
+
+private:
+    std::tuple<ComponentArray<Ts>*...> m_arrays;
+
+    template<typename T>
+    void pack(const Entity entity, const std::size_t position)
+    {
+        auto* array = std::get<ComponentArray<T>*>(m_arrays);
+        array->swap_positions(array->get_index(entity), position);
+    }
+};
+}
@@ -0,0 +1,119 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements observers: cached sets of the entities whose signature holds every component type of an
+// 'include' signature & none of an 'exclude' signature. The ecs manager keeps, per component type, an index
+// of the observers referring to that type, so a signature change only re-evaluates the observers of the
+// types that actually changed. Besides the current members, each observer collects the entities that
+// started & stopped matching since its consumer last cleared them, so systems can react to membership
+// changes once per tick rather than per component change. Systems' memberships are observers too (see
+// ecs/system_registry.h).
+//
+//     auto& observer = ecs_manager->register_observer<Transform, Collider>();
+//     for (const auto entity : observer.get_matched()) { ... }
+//     observer.clear_changes();
+
+#pragma once
+
+#include "ecs/common.h"
+
+#include <limits>
+#include <vector>
+
+namespace cgx::ecs
+{
+class Observer
+{
+public:
+    Observer(const Signature include, const Signature exclude)
+        : m_include(include)
+        , m_exclude(exclude) {}
+
+    [[nodiscard]] bool matches(const Signature& signature) const
+    {
+        return (signature & m_include) == m_include && (signature & m_exclude).none();
+    }
+
+    [[nodiscard]] const Signature& get_include() const { return m_include; }
+    [[nodiscard]] const Signature& get_exclude() const { return m_exclude; }
+
+    // current members, in no particular order
+    [[nodiscard]] const std::vector<Entity>& get_entities() const { return m_entities; }
+
+    [[nodiscard]] bool contains(const Entity entity) const
+    {
+        const std::uint32_t index = get_entity_index(entity);
+        return index < m_positions.size() && m_positions[index] != INVALID_POSITION
+               && m_entities[m_positions[index]] == entity;
+    }
+
+    // Entities that started / stopped matching since the last 'clear_changes'. An entity that matched &
+    // unmatched in between appears in both; unmatched entities may since have been released.
+    [[nodiscard]] const std::vector<Entity>& get_matched() const { return m_matched; }
+    [[nodiscard]] const std::vector<Entity>& get_unmatched() const { return m_unmatched; }
+
+    void clear_changes()
+    {
+        m_matched.clear();
+        m_unmatched.clear();
+    }
+
+private:
+    friend class ECSManager;
+    friend class SystemRegistry;
+
+    static constexpr std::uint32_t INVALID_POSITION = std::numeric_limits<std::uint32_t>::max();
+
+    Signature m_include;
+    Signature m_exclude;
+
+    std::vector<Entity>        m_entities{};
+    std::vector<std::uint32_t> m_positions{}; // indexed by entity index; position within m_entities
+
+    std::vector<Entity> m_matched{};
+    std::vector<Entity> m_unmatched{};
+
+    std::vector<Observer*>* m_change_list{nullptr}; // (appended to on the first change since 'clear_changes')
+
+    // Has the observer append itself to 'change_list' whenever it records a change after having none, so its
+    // consumer only visits the observers that changed.
+    void set_change_list(std::vector<Observer*>* change_list)
+    {
+        m_change_list = change_list;
+        if (!m_matched.empty() || !m_unmatched.empty()) {
+            m_change_list->push_back(this);
+        }
+    }
+
+    void record_change()
+    {
+        if (m_change_list != nullptr && m_matched.empty() && m_unmatched.empty()) {
+            m_change_list->push_back(this);
+        }
+    }
+
+    void on_entity_matched(const Entity entity)
+    {
+        record_change();
+        const std::uint32_t index = get_entity_index(entity);
+        if (index >= m_positions.size()) {
+            m_positions.resize(index + 1, INVALID_POSITION);
+        }
+        m_positions[index] = static_cast<std::uint32_t>(m_entities.size());
+        m_entities.push_back(entity);
+        m_matched.push_back(entity);
+    }
+
+    void on_entity_unmatched(const Entity entity)
+    {
+        record_change();
+        const std::uint32_t position = m_positions[get_entity_index(entity)];
+        const Entity        last     = m_entities.back();
+
+        m_entities[position]                  = last;
+        m_positions[get_entity_index(last)]   = position;
+        m_positions[get_entity_index(entity)] = INVALID_POSITION;
+        m_entities.pop_back();
+        m_unmatched.push_back(entity);
+    }
+};
+}
@@ -0,0 +1,197 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements the byte streams behind ecs world snapshots (see ECSManager::save_snapshot). A snapshot file
+// holds the entity handle & signature tables followed by one section per component type, holding the type's
+// dense entity list & component data. Trivially copyable components are stored as their raw bytes & loaded
+// by copying whole pages straight out of the memory-mapped file; other types (or any type given one) go
+// through a ComponentSerializer. Snapshots are meant for quick restarts & fixtures of the same build: they
+// store native-endian data & identify component types by their registration order, name & size.
+
+#pragma once
+
+#include "core/common.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace cgx::ecs
+{
+class SnapshotWriter
+{
+public:
+    void write_bytes(const void* data, const std::size_t size)
+    {
+        if (size == 0) {
+            return; // ('data' may be null, e.g. an empty vector's)
+        }
+        const auto* bytes = static_cast<const std::byte*>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes.");
+        write_bytes(&value, sizeof(T));
+    }
+
+    void write_string(const std::string& string)
+    {
+        write(static_cast<std::uint32_t>(string.size()));
+        write_bytes(string.data(), string.size());
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T>& values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes.");
+        write(static_cast<std::uint32_t>(values.size()));
+        write_bytes(values.data(), values.size() * sizeof(T));
+    }
+
+    // Reserves a size field, to be filled in through 'end_section' once the section's content is written.
+    [[nodiscard]] std::size_t begin_section()
+    {
+        const std::size_t offset = m_buffer.size();
+        write(std::uint64_t{0});
+        return offset;
+    }
+
+    void end_section(const std::size_t offset)
+    {
+        const std::uint64_t size = m_buffer.size() - offset - sizeof(std::uint64_t);
+        std::memcpy(m_buffer.data() + offset, &size, sizeof(size));
+    }
+
+    [[nodiscard]] const std::vector<std::byte>& get_buffer() const { return m_buffer; }
+
+private:
+    std::vector<std::byte> m_buffer{};
+};
+
+// Reads from a snapshot held in memory (typically a memory-mapped file). Reading past the end fails the reader
+// rather than the process: the read yields nothing (a null pointer, zeroed value, or empty string/vector) &
+// 'has_failed' turns true, so loaders can check a whole section before acting on any of it.
+class SnapshotReader
+{
+public:
+    SnapshotReader(const std::byte* data, const std::size_t size)
+        : m_data(data)
+        , m_size(size) {}
+
+    // Returns a pointer to the next 'size' bytes (within the snapshot's memory) & skips past them.
+    const std::byte* read_bytes(const std::size_t size)
+    {
+        if (size > get_remaining()) {
+            fail();
+            return nullptr;
+        }
+        const std::byte* bytes = m_data + m_offset;
+        m_offset += size;
+        return bytes;
+    }
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes.");
+        T value{};
+        if (const std::byte* bytes = read_bytes(sizeof(T))) {
+            std::memcpy(&value, bytes, sizeof(T));
+        }
+        return value;
+    }
+
+    std::string read_string()
+    {
+        const auto       size  = read<std::uint32_t>();
+        const std::byte* bytes = read_bytes(size);
+        if (bytes == nullptr) {
+            return {};
+        }
+        return {reinterpret_cast<const char*>(bytes), size};
+    }
+
+    template<typename T>
+    std::vector<T> read_vector()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes.");
+        const auto count = read<std::uint32_t>();
+        if (count > get_remaining() / sizeof(T)) { // (checked before allocating for a corrupt count)
+            fail();
+            return {};
+        }
+        std::vector<T> values(count);
+        if (!values.empty()) { // (an empty vector's data may be null)
+            std::memcpy(values.data(), read_bytes(values.size() * sizeof(T)), values.size() * sizeof(T));
+        }
+        return values;
+    }
+
+    // Returns a reader over the next section (see SnapshotWriter::begin_section) & skips past it. A section
+    // running past the end fails both readers.
+    SnapshotReader read_section()
+    {
+        const auto size = read<std::uint64_t>();
+        if (has_failed() || size > get_remaining()) {
+            fail();
+            SnapshotReader section(nullptr, 0);
+            section.fail();
+            return section;
+        }
+        return {read_bytes(static_cast<std::size_t>(size)), static_cast<std::size_t>(size)};
+    }
+
+    [[nodiscard]] std::size_t get_remaining() const { return m_size - m_offset; }
+    [[nodiscard]] bool        has_failed() const { return m_failed; }
+
+    // True if every read succeeded & consumed the reader exactly.
+    [[nodiscard]] bool is_complete() const { return !m_failed && m_offset == m_size; }
+
+private:
+    const std::byte* m_data;
+    std::size_t      m_size;
+    std::size_t      m_offset{0};
+    bool             m_failed{false};
+
+    void fail()
+    {
+        m_failed = true;
+        m_offset = m_size;
+    }
+};
+
+// Custom encoding of component type T in snapshots, for types that aren't trivially copyable (e.g. ones
+// owning heap memory or referring to assets). See ECSManager::set_component_serializer.
+template<typename T>
+struct ComponentSerializer
+{
+    std::function<void(const T&, SnapshotWriter&)> write{};
+    std::function<T(SnapshotReader&)>              read{};
+};
+
+// Read-only view of a file's contents; memory-mapped where supported, read into memory otherwise.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool             is_open() const { return m_data != nullptr; }
+    [[nodiscard]] const std::byte* get_data() const { return m_data; }
+    [[nodiscard]] std::size_t      get_size() const { return m_size; }
+
+private:
+    const std::byte*       m_data{nullptr};
+    std::size_t            m_size{0};
+    std::vector<std::byte> m_fallback{}; // (contents when not mapped)
+};
+}
@@ -6,6 +6,7 @@
 #include "ecs/ecs_manager.h"
 
 #include <set>
+#include <vector>
 
 namespace cgx::ecs
 {
@@ -23,6 +24,23 @@ public:
     virtual void on_entity_added(Entity entity) = 0;
     virtual void on_entity_removed(Entity entity) = 0;
 
+    // Called once for entities that joined the system together (bulk creation, command buffer flushes).
+    // Override when per-entity handling involves work that can be done once for the whole batch.
+    virtual void on_entities_added(const std::vector<Entity>& entities)
+    {
+        for (const auto entity : entities) {
+            on_entity_added(entity);
+        }
+    }
+
+    // Called once for entities that left the system together (batch release).
+    virtual void on_entities_removed(const std::vector<Entity>& entities)
+    {
+        for (const auto entity : entities) {
+            on_entity_removed(entity);
+        }
+    }
+
     template<typename T>
     T& get_component(const Entity entity)
     {
@@ -1,20 +1,55 @@
 // Copyright © 2024 Jacob Curlin
 
+// Implements registration & scheduling of systems. Systems run in registration order, except that systems
+// whose declared component access doesn't conflict may run concurrently on a worker pool: each system
+// declares the component types it reads & writes ('set_access'), and for every pair of systems where one
+// writes a type the other reads or writes, the later-registered system waits on the earlier one. The
+// resulting dependency graph is rebuilt whenever systems or their access declarations change. Ready systems
+// are submitted to the engine's job system (see core/job_system.h).
+// Systems that haven't declared their access are assumed to touch anything, and run alone on the calling
+// thread after every earlier system has finished.
+//
+// A system's members are the entities matching its signature, tracked by an observer over that signature (see
+// ecs/observer.h): signature changes only re-evaluate the systems referring to a changed component type, and
+// 'update_membership' only visits the systems whose observer recorded changes since.
+
 #pragma once
 
 #include "ecs/common.h"
+#include "utility/demangle.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
+
+namespace cgx::core
+{
+class JobSystem;
+}
 
 namespace cgx::ecs
 {
 class System;
+class Observer;
 
 class ECSManager;
 
+struct SystemTiming
+{
+    std::string name;
+    double      frame_update_ms{0.0}; // duration of the system's last frame update
+    double      fixed_update_ms{0.0}; // duration of the system's last fixed update
+};
+
 class SystemRegistry
 {
 public:
-    explicit SystemRegistry(ECSManager* ecs_manager);
+    SystemRegistry(ECSManager* ecs_manager, core::JobSystem* job_system);
     ~SystemRegistry();
 
     template<typename T>
@@ -22,32 +57,101 @@ public:
     {
         const char* type_name = typeid(T).name();
 
-        CGX_ASSERT(m_systems.find(type_name) == m_systems.end(), "Registering system more than once.");
+        CGX_ASSERT(m_system_indices.find(type_name) == m_system_indices.end(), "Registering system more than once.");
 
         auto system = std::make_shared<T>(m_ecs_manager);
-        m_systems.insert({type_name, system});
+        m_system_indices.insert({type_name, m_systems.size()});
+        m_systems.push_back({utility::get_unqualified_name(type_name), system});
+        m_schedule_dirty = true;
         return system;
     }
 
+    // Sets the component types system T's members hold; entities already holding them join right away. Set
+    // once per system.
     template<typename T>
-    void set_signature(Signature signature)
+    void set_signature(const Signature signature)
     {
-        const char* type_name = typeid(T).name();
-
-        CGX_ASSERT(m_systems.find(type_name) != m_systems.end(), "System used before being registered.");
+        set_signature(get_entry<T>(), signature);
+    }
 
-        m_signatures.insert({type_name, signature});
+    // Declares the component types system T reads & writes during its updates.
+    template<typename T>
+    void set_access(const Signature reads, const Signature writes)
+    {
+        auto& entry      = get_entry<T>();
+        entry.reads      = reads;
+        entry.writes     = writes;
+        entry.exclusive  = false;
+        m_schedule_dirty = true;
     }
 
     void frame_update(float dt);
     void fixed_update(float fixed_dt);
-    void on_entity_released(Entity entity) const;
-    void on_entity_updated(Entity entity, Signature entitySignature);
+
+    // Applies the membership changes recorded since the last call, in registration order: each changed system
+    // is notified once with every entity it lost, then once with every entity it gained (through the bulk
+    // overloads when there are several). Entities that joined & left in between (or the other way round) are
+    // left out. Changes made by systems reacting to the notifications are applied before returning.
+    void update_membership();
+
+    [[nodiscard]] std::vector<SystemTiming> get_timings() const;
 
 private:
+    enum class Phase
+    {
+        Frame,
+        Fixed
+    };
+
+    struct SystemEntry
+    {
+        std::string             name;
+        std::shared_ptr<System> system;
+        Observer*               observer{nullptr}; // (over the system's signature, once set)
+
+        Signature reads{};
+        Signature writes{};
+        bool      exclusive{true}; // (no access declared)
+
+        std::vector<std::size_t> dependents{};
+        std::size_t              dependency_count{0};
+
+        double frame_update_ms{0.0};
+        double fixed_update_ms{0.0};
+    };
+
     ECSManager* m_ecs_manager;
 
-    std::unordered_map<const char*, Signature>               m_signatures{};
-    std::unordered_map<const char*, std::shared_ptr<System>> m_systems{};
+    std::vector<SystemEntry>                     m_systems{}; // in registration order
+    std::unordered_map<const char*, std::size_t> m_system_indices{};
+    bool                                         m_schedule_dirty{true};
+
+    std::unordered_map<const Observer*, std::size_t> m_observer_systems{};  // observer -> index in m_systems
+    std::vector<Observer*>                           m_changed_observers{}; // (with changes not yet applied)
+
+    core::JobSystem* m_job_system;
+
+    // per-phase run state
+    std::unique_ptr<std::atomic<std::size_t>[]> m_pending_dependencies{}; // indexed like m_systems
+    std::deque<std::size_t>                     m_calling_thread_queue{};
+    std::size_t                                 m_remaining_systems{0};
+    std::mutex                                  m_run_mutex{};
+    std::condition_variable                     m_run_condition{};
+
+    template<typename T>
+    SystemEntry& get_entry()
+    {
+        const auto it = m_system_indices.find(typeid(T).name());
+        CGX_ASSERT(it != m_system_indices.end(), "System used before being registered.");
+        return m_systems[it->second];
+    }
+
+    void set_signature(SystemEntry& entry, Signature signature);
+    void update_membership(System& system, Observer& observer);
+
+    void build_schedule();
+    void run_phase(Phase phase, float dt);
+    void dispatch_system(std::size_t index, Phase phase, float dt);
+    void run_system(std::size_t index, Phase phase, float dt);
 };
 }
@@ -0,0 +1,178 @@
+// Copyright © 2024 Jacob Curlin
+
+// Implements typed, non-owning views over the entities holding every component type Ts. A view walks the
+// dense entity list of its smallest component array and only probes the remaining arrays' sparse slots, so
+// iteration costs O(smallest array) rather than O(matching entities * component lookups through the registry).
+// When an owning group covers exactly Ts (see ecs/group.h), the view walks the group's packed range instead,
+// and every component is read by index without any lookups at all.
+//
+//     for (auto [entity, transform, rigid_body] : ecs_manager->view<Transform, RigidBody>()) { ... }
+//
+// Components may be modified freely during iteration, but adding or removing components of a viewed type
+// (or releasing entities) invalidates the iteration.
+//
+// 'parallel_each' spreads the iteration across a job system in chunks. Group-backed chunks cover whole
+// component pages, which are cache-line aligned & padded, so no two threads ever write to the same cache line
+// of a viewed array.
+
+#pragma once
+
+#include "core/job_system.h"
+#include "ecs/common.h"
+#include "ecs/component_array.h"
+#include "ecs/group.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace cgx::ecs
+{
+template<typename... Ts>
+class View
+{
+public:
+    static_assert(sizeof...(Ts) > 0, "A view must cover at least one component type.");
+
+    class Iterator
+    {
+    public:
+        Iterator(const View* view, const std::size_t index)
+            : m_view(view)
+            , m_index(index)
+        {
+            skip_unmatched();
+        }
+
+        std::tuple<Entity, Ts&...> operator*() const
+        {
+            return m_view->get_at(m_index);
+        }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            skip_unmatched();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        const View* m_view;
+        std::size_t m_index;
+
+        void skip_unmatched()
+        {
+            while (m_index < m_view->m_end && !m_view->accepts(m_index)) {
+                ++m_index;
+            }
+        }
+    };
+
+    // 'group' is the owning group covering exactly Ts, if any.
+    View(ComponentArray<Ts>&... arrays, const IGroup* group)
+        : m_arrays(&arrays...)
+    {
+        if (group != nullptr) {
+            m_grouped       = true;
+            m_lead_entities = &std::get<0>(m_arrays)->get_entities();
+            m_end           = group->size();
+            return;
+        }
+
+        // lead with the smallest array; every match must appear in it
+        std::size_t smallest = std::numeric_limits<std::size_t>::max();
+        (select_lead(arrays, smallest), ...);
+        m_end = smallest;
+    }
+
+    [[nodiscard]] Iterator begin() const { return Iterator(this, 0); }
+    [[nodiscard]] Iterator end() const { return Iterator(this, m_end); }
+
+    // Invokes 'func(entity, Ts&...)' for every entity holding all of Ts.
+    template<typename Func>
+    void each(Func&& func) const
+    {
+        const auto& entities = *m_lead_entities;
+        if (m_grouped) {
+            for (std::size_t i = 0 ; i < m_end ; ++i) {
+                func(entities[i], std::get<ComponentArray<Ts>*>(m_arrays)->get_data_at(i)...);
+            }
+            return;
+        }
+        for (std::size_t i = 0 ; i < m_end ; ++i) {
+            const Entity entity = entities[i];
+            if ((std::get<ComponentArray<Ts>*>(m_arrays)->contains(entity) && ...)) {
+                func(entity, std::get<ComponentArray<Ts>*>(m_arrays)->get_data(entity)...);
+            }
+        }
+    }
+
+    // Invokes 'func(entity, Ts&...)' for every entity holding all of Ts, in chunks of roughly 'grain_size'
+    // entities run concurrently on 'job_system'. 'func' must be safe to call concurrently for distinct entities.
+    template<typename Func>
+    void parallel_each(core::JobSystem& job_system, std::size_t grain_size, Func&& func) const
+    {
+        const auto& entities = *m_lead_entities;
+        if (m_grouped) {
+            // round chunks up to whole component pages (separate, cache-line aligned allocations)
+            constexpr std::size_t page_size = ComponentArray<std::tuple_element_t<0, std::tuple<Ts...>>>::COMPONENT_PAGE_SIZE;
+            grain_size = std::max<std::size_t>((grain_size + page_size - 1) / page_size, 1) * page_size;
+
+            job_system.parallel_for(0, m_end, grain_size, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t i = begin ; i < end ; ++i) {
+                    func(entities[i], std::get<ComponentArray<Ts>*>(m_arrays)->get_data_at(i)...);
+                }
+            });
+            return;
+        }
+        job_system.parallel_for(0, m_end, grain_size, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin ; i < end ; ++i) {
+                const Entity entity = entities[i];
+                if ((std::get<ComponentArray<Ts>*>(m_arrays)->contains(entity) && ...)) {
+                    func(entity, std::get<ComponentArray<Ts>*>(m_arrays)->get_data(entity)...);
+                }
+            }
+        });
+    }
+
+    // Upper bound on the number of entities visited (exact when backed by a group).
+    [[nodiscard]] std::size_t size_hint() const { return m_end; }
+
+private:
+    std::tuple<ComponentArray<Ts>*...> m_arrays;
+    const std::vector<Entity>*         m_lead_entities{nullptr};
+    std::size_t                        m_end{0};
+    bool                               m_grouped{false};
+
+    template<typename T>
+    void select_lead(const ComponentArray<T>& array, std::size_t& smallest)
+    {
+        if (array.size() < smallest) {
+            smallest        = array.size();
+            m_lead_entities = &array.get_entities();
+        }
+    }
+
+    [[nodiscard]] bool accepts(const std::size_t index) const
+    {
+        if (m_grouped) {
+            return true;
+        }
+        const Entity entity = (*m_lead_entities)[index];
+        return (std::get<ComponentArray<Ts>*>(m_arrays)->contains(entity) && ...);
+    }
+
+    std::tuple<Entity, Ts&...> get_at(const std::size_t index) const
+    {
+        const Entity entity = (*m_lead_entities)[index];
+        if (m_grouped) {
+            return {entity, std::get<ComponentArray<Ts>*>(m_arrays)->get_data_at(index)...};
+        }
+        return {entity, std::get<ComponentArray<Ts>*>(m_arrays)->get_data(entity)...};
+    }
+};
+}
@@ -4,6 +4,7 @@
 
 #include "gui/imgui_panel.h"
 #include "gui/gui_context.h"
+#include "core/listener_list.h"
 
 #include <imgui/imgui.h>
 #include <vector>
@@ -50,6 +51,8 @@ public:
 private:
     bool m_interface_enabled{true};
 
+    std::vector<core::Subscription> m_subscriptions{};
+
     GUIContext*                              m_context{nullptr};
     std::vector<std::unique_ptr<ImGuiPanel>> m_imgui_panels;
 
@@ -21,6 +21,9 @@ public:
     void update();
 
 private:
+    // listener dispatch counts & times (see core::EventHandler::get_listener_profiles)
+    void render_event_profiles();
+
     uint32_t m_current_fps{0};
     double   m_last_frame_time{0.0f};
 
@@ -127,7 +127,7 @@ public:
     void                      set_camera(ecs::Entity camera_entity);
 
 private:
-    ecs::Entity m_camera{ecs::MAX_ENTITIES};
+    ecs::Entity m_camera{ecs::NULL_ENTITY};
 
     std::shared_ptr<Framebuffer> m_output_fb;
     std::shared_ptr<Framebuffer> m_gbuffer_fb;
@@ -57,7 +57,7 @@ public:
     core::ItemType::Type get_item_type() const override;
 
 private:
-    ecs::Entity m_entity{ecs::MAX_ENTITIES};
+    ecs::Entity m_entity{ecs::NULL_ENTITY};
     NodeFlag    m_flags{NodeFlag::None};
 };
 }
@@ -5,6 +5,9 @@
 #include "tiny_gltf.h"
 
 #include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
 
 
 namespace cgx::asset
@@ -18,6 +21,7 @@ class Texture;
 
 namespace cgx::ecs
 {
+class CommandBuffer;
 class ECSManager;
 }
 
@@ -45,10 +49,16 @@ private:
     asset::AssetManager* m_asset_manager{nullptr};
     ecs::ECSManager*     m_ecs_manager{nullptr};
 
+    using PendingLink = std::pair<std::shared_ptr<Node>, Node*>; // (node, parent)
+
+    // records the node's entity & components into 'commands' and its parent link into 'pending_links',
+    // applied by 'import' once the whole tree has been processed
     void process_node(
-        const tinygltf::Model& gltf_model,
-        const tinygltf::Node&  gltf_node,
-        Node*                  parent);
+        const tinygltf::Model&    gltf_model,
+        const tinygltf::Node&     gltf_node,
+        Node*                     parent,
+        ecs::CommandBuffer&       commands,
+        std::vector<PendingLink>& pending_links);
 
     std::shared_ptr<asset::Material> process_material(
         const tinygltf::Model&    gltf_model,
@@ -0,0 +1,15 @@
+// Copyright © 2024 Jacob Curlin
+
+#pragma once
+
+#include <string>
+
+namespace cgx::utility
+{
+// readable name of a type from its type_info name: demangled where the abi mangles it (gcc / clang), as-is
+// otherwise (msvc)
+std::string demangle(const char* type_name);
+
+// demangled name without namespaces (& msvc's 'class ' / 'struct ' prefix), e.g. for profiler labels
+std::string get_unqualified_name(const char* type_name);
+}
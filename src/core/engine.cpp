@@ -3,6 +3,7 @@
 #include "core/engine.h"
 #include "core/window_manager.h"
 #include "core/input_manager.h"
+#include "core/job_system.h"
 
 #include "core/systems/time_system.h"
 #include "physics/physics_system.h"
@@ -17,6 +18,7 @@
 #include "core/events/master_events.h"
 
 #include "core/components/render.h"
+#include "core/components/hierarchy.h"
 #include "core/components/transform.h"
 #include "core/components/rigid_body.h"
 #include "core/components/point_light.h"
@@ -36,8 +38,12 @@
 
 namespace cgx::core
 {
-Engine::Engine()  = default;
-Engine::~Engine() = default;
+Engine::Engine() = default;
+
+Engine::~Engine()
+{
+    EventHandler::get_instance().set_job_system(nullptr); // (the job system goes down with the engine)
+}
 
 // main game loop
 void Engine::run()
@@ -65,7 +71,9 @@ void Engine::initialize()
 
     InputManager::get_instance().initialize(m_window_manager);
 
-    m_ecs_manager = std::make_unique<ecs::ECSManager>();
+    m_job_system  = std::make_unique<JobSystem>();
+    m_ecs_manager = std::make_unique<ecs::ECSManager>(m_job_system.get());
+    EventHandler::get_instance().set_job_system(m_job_system.get());
 
     m_ecs_manager->register_component<component::Camera>();
     m_ecs_manager->register_component<component::Collider>();
@@ -76,30 +84,44 @@ void Engine::initialize()
     m_ecs_manager->register_component<component::Render>();
     m_ecs_manager->register_component<component::Transform>();
 
-    auto m_hierarchy_system = m_ecs_manager->register_system<HierarchySystem>(); {
+    // pack transform & rigid body columns for the physics integration loop
+    m_ecs_manager->register_group<component::Transform, component::RigidBody>();
+
+    const auto hierarchy_system = m_ecs_manager->register_system<HierarchySystem>(); {
         ecs::Signature signature;
         signature.set(m_ecs_manager->get_component_type<component::Hierarchy>());
         m_ecs_manager->set_system_signature<HierarchySystem>(signature);
+        m_ecs_manager->set_system_access<HierarchySystem>({}, {}); // (updates are no-ops)
     }
 
-    auto m_transform_system = m_ecs_manager->register_system<TransformSystem>(); {
+    m_ecs_manager->register_system<TransformSystem>()->set_hierarchy_system(hierarchy_system.get()); {
         ecs::Signature signature;
         signature.set(m_ecs_manager->get_component_type<component::Transform>());
         m_ecs_manager->set_system_signature<TransformSystem>(signature);
+
+        ecs::Signature reads, writes;
+        reads.set(m_ecs_manager->get_component_type<component::Hierarchy>());
+        writes.set(m_ecs_manager->get_component_type<component::Transform>());
+        m_ecs_manager->set_system_access<TransformSystem>(reads, writes);
     }
-    m_transform_system->initialize(m_hierarchy_system.get());
 
     m_ecs_manager->register_system<CameraSystem>(); {
         ecs::Signature signature;
         signature.set(m_ecs_manager->get_component_type<component::Camera>());
         signature.set(m_ecs_manager->get_component_type<component::Transform>());
         m_ecs_manager->set_system_signature<CameraSystem>(signature);
+
+        ecs::Signature reads, writes;
+        reads.set(m_ecs_manager->get_component_type<component::Transform>());
+        writes.set(m_ecs_manager->get_component_type<component::Camera>());
+        m_ecs_manager->set_system_access<CameraSystem>(reads, writes);
     }
 
     m_ecs_manager->register_system<ControlSystem>(); {
         ecs::Signature signature;
         signature.set(m_ecs_manager->get_component_type<component::Controllable>());
         m_ecs_manager->set_system_signature<ControlSystem>(signature);
+        // (no access declared: consumes input manager state, so it runs alone on the main thread)
     }
 
     m_ecs_manager->register_system<physics::PhysicsSystem>(); {
@@ -107,6 +129,11 @@ void Engine::initialize()
         signature.set(m_ecs_manager->get_component_type<component::RigidBody>());
         signature.set(m_ecs_manager->get_component_type<component::Transform>());
         m_ecs_manager->set_system_signature<physics::PhysicsSystem>(signature);
+
+        ecs::Signature writes;
+        writes.set(m_ecs_manager->get_component_type<component::Transform>());
+        writes.set(m_ecs_manager->get_component_type<component::RigidBody>());
+        m_ecs_manager->set_system_access<physics::PhysicsSystem>({}, writes);
     }
 
     m_ecs_manager->register_system<physics::CollisionSystem>(); {
@@ -115,6 +142,12 @@ void Engine::initialize()
         signature.set(m_ecs_manager->get_component_type<component::Transform>());
         signature.set(m_ecs_manager->get_component_type<component::Collider>());
         m_ecs_manager->set_system_signature<physics::CollisionSystem>(signature);
+
+        ecs::Signature reads, writes;
+        reads.set(m_ecs_manager->get_component_type<component::Collider>());
+        writes.set(m_ecs_manager->get_component_type<component::Transform>());
+        writes.set(m_ecs_manager->get_component_type<component::RigidBody>());
+        m_ecs_manager->set_system_access<physics::CollisionSystem>(reads, writes);
     }
 
     m_render_system = m_ecs_manager->register_system<render::RenderSystem>(); {
@@ -122,6 +155,7 @@ void Engine::initialize()
         // signature.set(m_ecs_manager->get_component_type<component::Render>());
         signature.set(m_ecs_manager->get_component_type<component::Transform>());
         m_ecs_manager->set_system_signature<render::RenderSystem>(signature);
+        m_ecs_manager->set_system_access<render::RenderSystem>({}, {}); // (updates are no-ops; renders separately)
     }
     m_render_system->initialize();
 
@@ -131,6 +165,8 @@ void Engine::initialize()
     m_asset_manager->register_importer(std::make_shared<asset::AssetImporterImage>());
     m_asset_manager->register_importer(std::make_shared<asset::AssetImporterOBJ>());
 
+    setup_component_serializers();
+
     m_scene_manager = std::make_shared<scene::SceneManager>(m_ecs_manager.get(), m_asset_manager.get());
 
     setup_gui();
@@ -144,6 +180,9 @@ void Engine::update()
     const auto dt = m_time_system->get_frame_time();
     m_time_system->add_accumulator(dt);
 
+    auto& event_handler = EventHandler::get_instance();
+    event_handler.flush(EventPhase::PreUpdate);
+
     while (m_time_system->get_accumulator() >= m_time_system->get_fixed_timestep()) {
         m_ecs_manager->fixed_update(static_cast<float>(m_time_system->get_fixed_timestep()));
         m_time_system->sub_accumulator(m_time_system->get_fixed_timestep());
@@ -151,6 +190,7 @@ void Engine::update()
 
     m_ecs_manager->frame_update(static_cast<float>(dt));
 
+    event_handler.flush(EventPhase::PostUpdate);
 }
 
 void Engine::render()
@@ -171,7 +211,7 @@ void Engine::setup_engine_events()
     // on . : toggle control mode
     const event::Event toggle_control_event(event::master::TOGGLE_CONTROL_MODE);
     input_manager.bind_key_input_event(Key::key_comma, KeyAction::press, toggle_control_event);
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::TOGGLE_CONTROL_MODE,
         [this](event::Event& event) {
             switch (m_control_mode) {
@@ -187,16 +227,46 @@ void Engine::setup_engine_events()
                 }
                 default: return;
             }
-        });
+        }));
 
     // on ` : quit engine & close window
     const event::Event quit_event(event::master::QUIT);
     input_manager.bind_key_input_event(Key::key_end, KeyAction::press, quit_event);
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::QUIT,
         [this](event::Event& event) {
             this->m_is_running = false;
-        });
+        }));
+}
+
+// snapshot encodings of the components that aren't trivially copyable (see ecs/snapshot.h)
+void Engine::setup_component_serializers()
+{
+    m_ecs_manager->set_component_serializer<component::Hierarchy>(component::get_hierarchy_serializer());
+
+    // assets are referred to by source path, as asset ids are only stable within a session
+    m_ecs_manager->set_component_serializer<component::Render>({
+        [](const component::Render& render, ecs::SnapshotWriter& writer) {
+            writer.write_string(render.model ? render.model->get_external_path() : std::string{});
+            writer.write_string(render.shader ? render.shader->get_external_path() : std::string{});
+            writer.write(render.visible);
+        },
+        [this](ecs::SnapshotReader& reader) {
+            const auto find_asset = [this](const std::string& path) -> std::shared_ptr<asset::Asset> {
+                if (path.empty()) {
+                    return nullptr;
+                }
+                const auto asset_id = m_asset_manager->get_id_by_path(path);
+                return asset_id != asset::k_invalid_id ? m_asset_manager->get_asset(asset_id) : nullptr;
+            };
+
+            component::Render render;
+            render.model   = std::dynamic_pointer_cast<asset::Model>(find_asset(reader.read_string()));
+            render.shader  = std::dynamic_pointer_cast<asset::Shader>(find_asset(reader.read_string()));
+            render.visible = reader.read<bool>();
+            return render;
+        }
+    });
 }
 
 void Engine::setup_gui()
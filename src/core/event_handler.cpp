@@ -3,34 +3,129 @@
 #include "core/event_handler.h"
 #include "../../include/core/event.h"
 
+#include <string_view>
+
 namespace cgx::core
 {
 EventHandler::EventHandler() = default;
 
+EventHandler::~EventHandler()
+{
+    wait_for_worker_listeners();
+    while (MpscNode* node = m_posted_events.pop()) {
+        delete static_cast<IPostedEvent*>(node);
+    }
+}
+
 EventHandler& EventHandler::get_instance()
 {
     static EventHandler instance;
     return instance;
 }
 
-void EventHandler::add_listener(const event::EventId event_id, std::function<void(event::Event&)> const& listener)
+void EventHandler::flush(const EventPhase phase)
+{
+    wait_for_worker_listeners();
+    enqueue_posted_events();
+
+    m_flushing_channels.swap(m_queued_channels[static_cast<std::size_t>(phase)]);
+    for (auto* channel : m_flushing_channels) {
+        channel->flush();
+    }
+    m_flushing_channels.clear();
+}
+
+void EventHandler::set_job_system(JobSystem* job_system)
 {
-    m_listeners[event_id].push_back(listener);
+    wait_for_worker_listeners();
+
+    m_job_system = job_system;
+    for (const auto& channel : m_channels) {
+        if (channel) {
+            channel->set_job_system(job_system, &m_worker_counter);
+        }
+    }
+}
+
+void EventHandler::enqueue_posted_events()
+{
+    while (MpscNode* node = m_posted_events.pop()) {
+        auto* posted_event = static_cast<IPostedEvent*>(node);
+        posted_event->enqueue(*this);
+        posted_event->release();
+    }
+}
+
+void EventHandler::wait_for_worker_listeners()
+{
+    if (m_job_system != nullptr) {
+        m_job_system->wait(m_worker_counter);
+    }
+}
+
+Subscription EventHandler::add_listener(
+    const event::EventId               event_id,
+    std::function<void(event::Event&)> listener,
+    const ListenerPriority             priority,
+    const std::source_location         location)
+{
+    // (map nodes, & so subscribed lists, stay in place)
+    return m_listeners[event_id].add(std::move(listener), ListenerAffinity::MainThread, priority, location);
 }
 
 void EventHandler::send_event(event::Event& event)
 {
-    for (auto const& listener : m_listeners[event.get_type()]) {
-        listener(event);
+    if (const auto it = m_listeners.find(event.get_type()) ; it != m_listeners.end()) {
+        it->second.dispatch([&event](const auto& entry) { entry.func(event); });
     }
 }
 
 void EventHandler::send_event(const event::EventId event_id)
 {
     event::Event event(event_id);
+    send_event(event);
+}
 
-    for (auto const& listener : m_listeners[event_id]) {
-        listener(event);
+std::vector<ListenerProfile> EventHandler::get_listener_profiles() const
+{
+    std::vector<ListenerProfile> profiles;
+#if defined(CGX_EVENT_PROFILING)
+    for (const auto& channel : m_channels) {
+        if (channel) {
+            channel->collect_profiles(profiles);
+        }
+    }
+    for (const auto& [event_id, listeners] : m_listeners) {
+        const std::string event = "event " + std::to_string(event_id);
+        listeners.for_each_stats([&](const auto& entry) {
+            profiles.push_back({event, get_listener_label(entry.location), false, entry.stats});
+        });
+    }
+#endif
+    return profiles;
+}
+
+void EventHandler::reset_listener_profiles()
+{
+#if defined(CGX_EVENT_PROFILING)
+    for (const auto& channel : m_channels) {
+        if (channel) {
+            channel->reset_profiles();
+        }
+    }
+    for (auto& [event_id, listeners] : m_listeners) {
+        listeners.reset_stats();
+    }
+#endif
+}
+
+std::string get_listener_label(const std::source_location& location)
+{
+    // (file name only; paths are long & mostly shared)
+    std::string_view file = location.file_name();
+    if (const auto pos = file.find_last_of("/\\") ; pos != std::string_view::npos) {
+        file.remove_prefix(pos + 1);
     }
+    return std::string(file) + ":" + std::to_string(location.line());
 }
 }
@@ -0,0 +1,179 @@
+// Copyright © 2024 Jacob Curlin
+
+#include "core/job_system.h"
+
+namespace cgx::core
+{
+namespace
+{
+// the pool (& deque) owned by the current thread, if it's a worker
+thread_local const JobSystem* t_job_system  = nullptr;
+thread_local std::size_t      t_queue_index = 0;
+}
+
+std::size_t JobSystem::get_default_worker_count()
+{
+    const unsigned int hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 1 ? hardware_threads - 1 : 0;
+}
+
+JobSystem::JobSystem(const std::size_t worker_count)
+{
+    m_queues.reserve(worker_count + 1);
+    for (std::size_t i = 0 ; i < worker_count + 1 ; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_workers.reserve(worker_count);
+    for (std::size_t i = 0 ; i < worker_count ; ++i) {
+        m_workers.emplace_back(&JobSystem::worker_loop, this, i + 1);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_wake_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+{
+    if (counter != nullptr) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency != nullptr) {
+        std::lock_guard lock(dependency->m_mutex);
+        if (dependency->m_pending.load(std::memory_order_acquire) != 0) {
+            dependency->m_continuations.push_back({std::move(job), counter});
+            return;
+        }
+    }
+
+    push({std::move(job), counter});
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    while (!counter.is_done()) {
+        Job job;
+        if (try_pop(job)) {
+            run(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    // the job completing the counter may still hold its lock
+    std::lock_guard lock(counter.m_mutex);
+}
+
+std::size_t JobSystem::get_queue_index() const
+{
+    return t_job_system == this ? t_queue_index : 0;
+}
+
+void JobSystem::push(Job job)
+{
+    m_queued_jobs.fetch_add(1, std::memory_order_release);
+    {
+        auto&           queue = *m_queues[get_queue_index()];
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    if (!m_workers.empty()) {
+        // (empty critical section; orders the wake-up after a sleeping worker's predicate check)
+        { std::lock_guard lock(m_sleep_mutex); }
+        m_wake_condition.notify_one();
+    }
+}
+
+bool JobSystem::try_pop(Job& job)
+{
+    if (m_queued_jobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    const std::size_t own_index = get_queue_index();
+
+    // own deque from the back
+    {
+        auto&           queue = *m_queues[own_index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // steal from the front of the others
+    for (std::size_t offset = 1 ; offset < m_queues.size() ; ++offset) {
+        auto&           queue = *m_queues[(own_index + offset) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::run(Job& job)
+{
+    job.func();
+
+    JobCounter* counter = job.counter;
+    if (counter == nullptr) {
+        return;
+    }
+
+    // decremented under the counter's lock, so 'wait' can tell when the counter is no longer in use
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter->m_continuations); // (release the jobs depending on it)
+    }
+    for (auto& continuation : continuations) {
+        push({std::move(continuation.job), continuation.counter});
+    }
+}
+
+void JobSystem::worker_loop(const std::size_t queue_index)
+{
+    t_job_system  = this;
+    t_queue_index = queue_index;
+
+    while (true) {
+        Job job;
+        if (try_pop(job)) {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake_condition.wait(lock, [this] {
+            return m_stopping || m_queued_jobs.load(std::memory_order_acquire) != 0;
+        });
+        if (m_stopping && m_queued_jobs.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+}
@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace cgx::core
 {
@@ -17,17 +18,10 @@ CameraSystem::~CameraSystem() = default;
 
 void CameraSystem::frame_update(float dt)
 {
-    for (const auto& entity : m_entities) {
-        auto& camera    = get_component<component::Camera>(entity);
-        auto& transform = get_component<component::Transform>(entity);
-
-        auto view = glm::mat4(1.0f);
-
-        // compute the view matrix based on the transform component
-        view = rotate(view, glm::radians(-transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        view = rotate(view, glm::radians(-transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        view = rotate(view, glm::radians(-transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        view = translate(view, -transform.translation);
+    for (auto [entity, camera, transform] : m_ecs_manager->view<component::Camera, component::Transform>()) {
+        // compute the view matrix (the inverse of the camera's rotation & translation) from the transform
+        // component; the inverse of a unit quaternion is its conjugate
+        const glm::mat4 view = glm::translate(glm::mat4_cast(glm::conjugate(transform.rotation)), -transform.translation);
 
         if (camera.type == component::Camera::Type::Perspective) {
             camera.proj_matrix = glm::perspective(
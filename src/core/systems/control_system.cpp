@@ -1,13 +1,13 @@
 // Copyright © 2024 Jacob Curlin, Connor Cotturone, Chip Bevil, William Osborne
 
-#define GLM_ENABLE_EXPERIMENTAL
-
 #include "core/systems/control_system.h"
 
 #include "core/components/controllable.h"
 #include "core/components/transform.h"
 #include <glm/glm.hpp>
-#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
 
 #include "core/input_manager.h"
 #include "core/events/master_events.h"
@@ -19,17 +19,17 @@ ControlSystem::ControlSystem(ecs::ECSManager* ecs_manager)
     : System(ecs_manager)
 {
     auto& event_handler = EventHandler::get_instance();
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::ACTIVATE_GUI_CONTROL_MODE,
         [this](event::Event& event) {
             this->m_enabled = false;
-        });
-    event_handler.add_listener(
+        }));
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::ACTIVATE_GAME_CONTROL_MODE,
         [this](event::Event& event) {
             InputManager::get_instance().reset();
             this->m_enabled = true;
-        });
+        }));
 }
 
 ControlSystem::~ControlSystem() = default;
@@ -51,6 +51,9 @@ void ControlSystem::fixed_update(const float dt)
             if (controllable.enable_rotation) {
                 update_orientation(transform, controllable.rotation_speed, dt);
             }
+            if (controllable.enable_translation || controllable.enable_rotation) {
+                m_ecs_manager->mark_changed<component::Transform>(entity);
+            }
         }
     }
 }
@@ -75,8 +78,7 @@ void ControlSystem::update_position(component::Transform& transform, const glm::
     }
 
     if (relative) {
-        glm::mat4 rotation_matrix = glm::toMat4(glm::quat(glm::radians(transform.rotation)));
-        movement = glm::vec3(rotation_matrix * glm::vec4(movement, 0.0f));
+        movement = transform.rotation * movement;
     }
 
     if (input_manager.is_key_pressed(Key::key_space)) {
@@ -86,7 +88,6 @@ void ControlSystem::update_position(component::Transform& transform, const glm::
         movement.y -= movement_speed.y * dt;
     }
 
-    transform.dirty = true;
     transform.translation += movement;
 }
 
@@ -97,11 +98,15 @@ void ControlSystem::update_orientation(component::Transform& transform, const gl
     double x_offset, y_offset;
     input_manager.get_mouse_offset(x_offset, y_offset);
 
-    transform.rotation.y -= static_cast<float>(x_offset * rotation_speed.x);
-    transform.rotation.x += static_cast<float>(y_offset * rotation_speed.y);
+    // yaw about the world's up axis, pitch about the local right axis (keeping the pitch within +/- 89 degrees)
+    const glm::vec3 forward     = transform.rotation * glm::vec3(0.0f, 0.0f, -1.0f);
+    const float     pitch       = glm::degrees(std::asin(glm::clamp(forward.y, -1.0f, 1.0f)));
+    const float     yaw_delta   = -static_cast<float>(x_offset * rotation_speed.x);
+    const float     pitch_delta = glm::clamp(pitch + static_cast<float>(y_offset * rotation_speed.y), -89.0f, 89.0f) - pitch;
 
-    transform.dirty      = true;
-    transform.rotation.x = glm::clamp(transform.rotation.x, -89.0f, 89.0f);
+    transform.rotation = glm::normalize(
+        glm::angleAxis(glm::radians(yaw_delta), glm::vec3(0.0f, 1.0f, 0.0f)) * transform.rotation *
+        glm::angleAxis(glm::radians(pitch_delta), glm::vec3(1.0f, 0.0f, 0.0f)));
 }
 
 void ControlSystem::on_entity_added(ecs::Entity entity) {}
@@ -6,19 +6,30 @@
 
 #include "core/events/ecs_events.h"
 
+#include <algorithm>
+
 namespace cgx::core
 {
+namespace
+{
+// (parent links are applied before other listeners of parent updates observe the hierarchy)
+constexpr ListenerPriority k_parent_update_priority = 100;
+
+// changes touching at least 1 / k_batch_ratio of the nodes rebuild the order rather than splicing each in
+constexpr std::size_t k_batch_ratio = 8;
+}
+
 HierarchySystem::HierarchySystem(ecs::ECSManager* ecs_manager)
     : System(ecs_manager)
 {
-    EventHandler::get_instance().add_listener(
-        event::component::hierarchy::PARENT_UPDATE,
-        [this](event::Event& event) {
-            this->on_parent_update(
-                event.get_param<ecs::Entity>(event::component::hierarchy::CHILD),
-                event.get_param<ecs::Entity>(event::component::hierarchy::OLD_PARENT),
-                event.get_param<ecs::Entity>(event::component::hierarchy::NEW_PARENT));
-        });
+    // (queued by nodes; delivered after the update's command buffer flush, which adds new nodes' components)
+    auto& event_handler = EventHandler::get_instance();
+    event_handler.set_delivery_phase<event::component::hierarchy::ParentUpdated>(EventPhase::PostUpdate);
+    m_subscriptions.push_back(event_handler.add_batch_listener<event::component::hierarchy::ParentUpdated>(
+        [this](const std::span<const event::component::hierarchy::ParentUpdated> events) {
+            this->on_parent_updates(events);
+        },
+        k_parent_update_priority));
 }
 
 HierarchySystem::~HierarchySystem() = default;
@@ -28,18 +39,50 @@ void HierarchySystem::fixed_update(float dt) {} // do nothing
 
 void HierarchySystem::on_entity_added(const ecs::Entity entity)
 {
-    m_order.push_back(entity);
-    sort_order_by_depth();
+    if (is_deferred()) {
+        m_order_dirty = true;
+        return;
+    }
+    place(entity);
+    place_displaced(); // (the node may be the parent nodes added before it wait for)
 }
 
 void HierarchySystem::on_entity_removed(const ecs::Entity entity)
-{}
+{
+    if (is_deferred()) {
+        m_order_dirty = true;
+        return;
+    }
+    remove(entity);
+}
+
+void HierarchySystem::on_entities_added(const std::vector<ecs::Entity>& entities)
+{
+    if (!should_batch(entities.size())) {
+        System::on_entities_added(entities);
+        return;
+    }
+    begin_batch();
+    m_order_dirty = true;
+    end_batch();
+}
+
+void HierarchySystem::on_entities_removed(const std::vector<ecs::Entity>& entities)
+{
+    if (!should_batch(entities.size())) {
+        System::on_entities_removed(entities);
+        return;
+    }
+    begin_batch();
+    m_order_dirty = true;
+    end_batch();
+}
 
 void HierarchySystem::on_parent_update(const ecs::Entity child, const ecs::Entity old_parent, const ecs::Entity new_parent)
 {
     CGX_ASSERT(m_ecs_manager->has_component<component::Hierarchy>(child), "no hierarchy component associated with specified child");
 
-    if (old_parent != ecs::MAX_ENTITIES && m_entities.find(old_parent) != m_entities.end()) {
+    if (old_parent != ecs::NULL_ENTITY && m_entities.find(old_parent) != m_entities.end()) {
         auto& old_parent_component = m_ecs_manager->get_component<component::Hierarchy>(old_parent);
         auto it = std::find(old_parent_component.children.begin(), old_parent_component.children.end(), child);
         if (it != old_parent_component.children.end()) {
@@ -48,7 +91,7 @@ void HierarchySystem::on_parent_update(const ecs::Entity child, const ecs::Entit
     }
 
     // if new parent exists,
-    if (new_parent != ecs::MAX_ENTITIES && m_entities.find(new_parent) != m_entities.end()) {
+    if (new_parent != ecs::NULL_ENTITY && m_entities.find(new_parent) != m_entities.end()) {
         auto& new_parent_component = m_ecs_manager->get_component<component::Hierarchy>(new_parent);
         new_parent_component.children.push_back(child);
     }
@@ -56,40 +99,322 @@ void HierarchySystem::on_parent_update(const ecs::Entity child, const ecs::Entit
     auto& child_component = m_ecs_manager->get_component<component::Hierarchy>(child);
     child_component.parent = new_parent;
     if (m_ecs_manager->has_component<component::Transform>(child)) {
-        auto& child_transform = m_ecs_manager->get_component<component::Transform>(child);
-        child_transform.dirty = true;
+        m_ecs_manager->mark_changed<component::Transform>(child);
+    }
+
+    if (is_deferred()) {
+        m_order_dirty = true;
+        return;
     }
-    sort_order_by_depth();
+    reparent(child);
 }
 
-void HierarchySystem::sort_order_by_depth()
+void HierarchySystem::on_parent_updates(const std::span<const event::component::hierarchy::ParentUpdated> events)
 {
-    m_order.clear();
-    std::unordered_set<ecs::Entity> visited;
-
-    for (const auto& entity : m_entities) {
-        auto& hierarchy = m_ecs_manager->get_component<component::Hierarchy>(entity);
-        if (hierarchy.parent == ecs::MAX_ENTITIES && visited.find(entity) == visited.end()) {
-            dfs_children(entity, visited);
+    const bool batch = should_batch(events.size());
+    if (batch) {
+        begin_batch();
+    }
+    for (const auto& event : events) {
+        if (m_ecs_manager->is_valid(event.child) && m_ecs_manager->has_component<component::Hierarchy>(event.child)) {
+            on_parent_update(event.child, event.old_parent, event.new_parent);
         }
     }
+    if (batch) {
+        end_batch();
+    }
 }
 
-void HierarchySystem::dfs_children(const ecs::Entity entity, std::unordered_set<ecs::Entity>& visited)
+void HierarchySystem::begin_batch()
 {
-    visited.insert(entity);
+    ++m_batch_depth;
+}
+
+void HierarchySystem::end_batch()
+{
+    CGX_ASSERT(m_batch_depth > 0, "end_batch called without a matching begin_batch");
+    if (--m_batch_depth == 0 && m_order_dirty) {
+        rebuild_order();
+    }
+}
+
+const std::vector<ecs::Entity>& HierarchySystem::get_order()
+{
+    if (m_order_dirty) {
+        rebuild_order();
+    }
+    if (m_tombstone_count > 0) {
+        compact_order();
+    }
+    return m_order;
+}
+
+ecs::Entity HierarchySystem::get_parent(const ecs::Entity entity) const
+{
+    return is_placed(entity) ? m_nodes[ecs::get_entity_index(entity)].parent : ecs::NULL_ENTITY;
+}
+
+bool HierarchySystem::is_placed(const ecs::Entity entity) const
+{
+    const std::uint32_t index = ecs::get_entity_index(entity);
+    if (entity == ecs::NULL_ENTITY || index >= m_nodes.size()) {
+        return false;
+    }
+    const std::uint32_t position = m_nodes[index].position;
+    return position < m_order.size() && m_order[position] == entity;
+}
+
+bool HierarchySystem::should_batch(const std::size_t change_count) const
+{
+    return !is_deferred() && change_count > 1 && change_count * k_batch_ratio >= m_entities.size();
+}
+
+HierarchySystem::OrderNode& HierarchySystem::get_node(const ecs::Entity entity)
+{
+    const std::uint32_t index = ecs::get_entity_index(entity);
+    if (index >= m_nodes.size()) {
+        m_nodes.resize(index + 1);
+    }
+    return m_nodes[index];
+}
+
+void HierarchySystem::place(const ecs::Entity entity)
+{
+    if (is_placed(entity)) {
+        return;
+    }
+    get_node(entity) = {static_cast<std::uint32_t>(m_order.size()), 1, ecs::NULL_ENTITY};
     m_order.push_back(entity);
 
-    auto& hierarchy = m_ecs_manager->get_component<component::Hierarchy>(entity);
-    for (const auto& child : hierarchy.children) {
-        if (visited.find(child) == visited.end()) {
-            dfs_children(child, visited);
+    const auto& hierarchy = m_ecs_manager->get_component<component::Hierarchy>(entity);
+    if (is_placed(hierarchy.parent)) {
+        attach(entity, hierarchy.parent);
+    }
+    else if (hierarchy.parent != ecs::NULL_ENTITY) {
+        m_displaced.push_back(entity); // (parent not a node yet, or not placed yet while rebuilding)
+    }
+
+    // adopt listed children placed (as roots) before this node joined
+    for (const auto child : hierarchy.children) {
+        if (is_placed(child) && get_node(child).parent == ecs::NULL_ENTITY
+            && m_ecs_manager->get_component<component::Hierarchy>(child).parent == entity) {
+            detach(child);
+            attach(child, entity);
         }
     }
 }
 
-const std::vector<ecs::Entity>& HierarchySystem::get_order() const
+void HierarchySystem::remove(const ecs::Entity entity)
 {
-    return m_order;
+    if (!is_placed(entity)) {
+        return;
+    }
+    OrderNode& node = get_node(entity);
+
+    // the node's children become roots; their subtrees move to the end of the order
+    if (node.size > 1) {
+        const std::size_t begin = node.position + 1;
+        const std::size_t end   = node.position + node.size;
+        std::rotate(m_order.begin() + begin, m_order.begin() + end, m_order.end());
+        refresh_positions(begin, m_order.size());
+        resize_ancestors(entity, -static_cast<std::int64_t>(end - begin));
+
+        for (std::size_t position = m_order.size() - (end - begin) ; position < m_order.size() ;) {
+            if (m_order[position] == ecs::NULL_ENTITY) {
+                ++position;
+                continue;
+            }
+            OrderNode& child = get_node(m_order[position]);
+            child.parent     = ecs::NULL_ENTITY;
+            m_displaced.push_back(m_order[position]); // (until the node rejoins)
+            position += child.size;
+        }
+    }
+
+    // (the slot stays counted in the ancestors' subtrees until compacted)
+    m_order[node.position] = ecs::NULL_ENTITY;
+    node.parent            = ecs::NULL_ENTITY;
+    ++m_tombstone_count;
+
+    if (m_tombstone_count * 2 > m_order.size()) {
+        compact_order();
+    }
+    place_displaced(); // (the node may have closed a cycle)
+}
+
+void HierarchySystem::reparent(const ecs::Entity entity)
+{
+    if (!is_placed(entity)) {
+        place(entity);
+        return;
+    }
+    detach(entity);
+
+    const ecs::Entity parent = m_ecs_manager->get_component<component::Hierarchy>(entity).parent;
+    if (is_placed(parent)) {
+        attach(entity, parent);
+    }
+    place_displaced();
+}
+
+void HierarchySystem::place_displaced()
+{
+    if (m_displaced.empty()) {
+        return;
+    }
+    m_stack.swap(m_displaced);
+    m_displaced.clear();
+    std::sort(m_stack.begin(), m_stack.end());
+    m_stack.erase(std::unique(m_stack.begin(), m_stack.end()), m_stack.end());
+
+    for (const auto entity : m_stack) {
+        if (!is_placed(entity) || get_node(entity).parent != ecs::NULL_ENTITY) {
+            continue;
+        }
+        const ecs::Entity parent = m_ecs_manager->get_component<component::Hierarchy>(entity).parent;
+        if (is_placed(parent)) {
+            detach(entity);
+            attach(entity, parent); // (displaced again while still below its own subtree)
+        }
+        else if (parent != ecs::NULL_ENTITY) {
+            m_displaced.push_back(entity); // (keeps waiting for its parent)
+        }
+    }
+    m_stack.clear();
+}
+
+void HierarchySystem::detach(const ecs::Entity entity)
+{
+    OrderNode&        node  = get_node(entity);
+    const std::size_t begin = node.position;
+    const std::size_t end   = node.position + node.size;
+
+    if (end != m_order.size()) {
+        std::rotate(m_order.begin() + begin, m_order.begin() + end, m_order.end());
+        refresh_positions(begin, m_order.size());
+    }
+    resize_ancestors(node.parent, -static_cast<std::int64_t>(node.size));
+    node.parent = ecs::NULL_ENTITY;
+}
+
+void HierarchySystem::attach(const ecs::Entity entity, const ecs::Entity parent)
+{
+    OrderNode&        node          = get_node(entity);
+    const OrderNode&  parent_node   = get_node(parent);
+    const std::size_t subtree_begin = m_order.size() - node.size;
+    CGX_ASSERT(node.position == subtree_begin, "attached subtrees must end the order");
+
+    if (parent_node.position >= subtree_begin) {
+        m_displaced.push_back(entity); // (reparented below itself; stays a root)
+        return;
+    }
+
+    const std::size_t insert_position = parent_node.position + parent_node.size;
+    std::rotate(m_order.begin() + insert_position, m_order.begin() + subtree_begin, m_order.end());
+    refresh_positions(insert_position, m_order.size());
+    resize_ancestors(parent, node.size);
+    node.parent = parent;
+}
+
+void HierarchySystem::resize_ancestors(ecs::Entity parent, const std::int64_t delta)
+{
+    while (parent != ecs::NULL_ENTITY) {
+        OrderNode& node = get_node(parent);
+        node.size       = static_cast<std::uint32_t>(node.size + delta);
+        parent          = node.parent;
+    }
+}
+
+void HierarchySystem::refresh_positions(const std::size_t begin, const std::size_t end)
+{
+    for (std::size_t position = begin ; position < end ; ++position) {
+        if (m_order[position] != ecs::NULL_ENTITY) {
+            get_node(m_order[position]).position = static_cast<std::uint32_t>(position);
+        }
+    }
+}
+
+void HierarchySystem::rebuild_order()
+{
+    m_order_dirty = false;
+    m_order.clear();
+    m_displaced.clear();
+    m_tombstone_count = 0;
+
+    // roots (nodes whose parent isn't a node), depth-first through their listed children
+    for (const auto root : m_entities) {
+        const ecs::Entity root_parent = m_ecs_manager->get_component<component::Hierarchy>(root).parent;
+        if (m_entities.find(root_parent) != m_entities.end()) {
+            continue;
+        }
+        if (root_parent != ecs::NULL_ENTITY) {
+            m_displaced.push_back(root); // (waits for its parent to become a node)
+        }
+
+        m_stack.clear();
+        m_stack.push_back(root);
+        while (!m_stack.empty()) {
+            const ecs::Entity entity = m_stack.back();
+            m_stack.pop_back();
+            if (is_placed(entity)) {
+                continue; // (listed twice)
+            }
+
+            const auto& hierarchy = m_ecs_manager->get_component<component::Hierarchy>(entity);
+            get_node(entity)      = {static_cast<std::uint32_t>(m_order.size()), 1,
+                                     entity == root ? ecs::NULL_ENTITY : hierarchy.parent};
+            m_order.push_back(entity);
+
+            // (pushed last to first, so children are visited in order)
+            for (auto it = hierarchy.children.rbegin() ; it != hierarchy.children.rend() ; ++it) {
+                const ecs::Entity child = *it;
+                if (m_entities.find(child) != m_entities.end() && !is_placed(child)
+                    && m_ecs_manager->get_component<component::Hierarchy>(child).parent == entity) {
+                    m_stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    // (children follow their parent, so summing back to front completes each subtree before its parent's)
+    for (std::size_t position = m_order.size() ; position-- > 0 ;) {
+        const OrderNode& node = get_node(m_order[position]);
+        if (node.parent != ecs::NULL_ENTITY) {
+            get_node(node.parent).size += node.size;
+        }
+    }
+
+    // nodes their parent doesn't list, & cycles (nodes placed before their parent are attached once it is)
+    if (m_order.size() < m_entities.size()) {
+        for (const auto entity : m_entities) {
+            place(entity);
+        }
+    }
+    place_displaced();
+}
+
+void HierarchySystem::compact_order()
+{
+    // tombstones before each position, to shrink the subtrees spanning them
+    m_tombstone_prefix.resize(m_order.size() + 1);
+    m_tombstone_prefix[0] = 0;
+    for (std::size_t position = 0 ; position < m_order.size() ; ++position) {
+        m_tombstone_prefix[position + 1] = m_tombstone_prefix[position] + (m_order[position] == ecs::NULL_ENTITY ? 1 : 0);
+    }
+
+    std::size_t live_count = 0;
+    for (std::size_t position = 0 ; position < m_order.size() ; ++position) {
+        const ecs::Entity entity = m_order[position];
+        if (entity == ecs::NULL_ENTITY) {
+            continue;
+        }
+        OrderNode& node = get_node(entity);
+        node.size -= m_tombstone_prefix[position + node.size] - m_tombstone_prefix[position];
+        node.position = static_cast<std::uint32_t>(live_count);
+        m_order[live_count++] = entity;
+    }
+
+    m_order.resize(live_count);
+    m_tombstone_count = 0;
 }
 }
@@ -4,21 +4,32 @@
 #include "ecs/ecs_manager.h"
 #include "core/components/hierarchy.h"
 #include "core/systems/hierarchy_system.h"
+#include "core/event_handler.h"
+#include "core/events/ecs_events.h"
 
 #include <glm/glm.hpp>
-#include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace cgx::core
 {
 
 TransformSystem::TransformSystem(ecs::ECSManager* ecs_manager)
-    : System(ecs_manager) {}
+    : System(ecs_manager)
+{
+    m_hierarchy_observer = &m_ecs_manager->register_observer<component::Transform, component::Hierarchy>();
+
+    // (after the hierarchy system's listener has applied the new parents)
+    m_subscriptions.push_back(
+        EventHandler::get_instance().add_batch_listener<event::component::hierarchy::ParentUpdated>(
+            [this](std::span<const event::component::hierarchy::ParentUpdated>) { m_table_stale = true; }));
+}
 
 TransformSystem::~TransformSystem() = default;
 
-void TransformSystem::initialize(HierarchySystem* hierarchy_system)
+void TransformSystem::set_hierarchy_system(HierarchySystem* hierarchy_system)
 {
     m_hierarchy_system = hierarchy_system;
+    m_table_stale      = true;
 }
 
 void TransformSystem::frame_update(float dt)
@@ -28,58 +39,116 @@ void TransformSystem::frame_update(float dt)
 
 void TransformSystem::fixed_update(float dt)
 {
-    for (const auto& entity : m_hierarchy_system->get_order()) {
-        if (m_entities.find(entity) == m_entities.end()) {
-            continue; // continue if entity lacks transform component
-        }
-        auto& transform = m_ecs_manager->get_component<component::Transform>(entity);
-        if (transform.dirty) {
+    const ecs::ChangeTick tick = m_ecs_manager->get_change_tick();
 
-            ecs::Entity parent = ecs::MAX_ENTITIES;
-            if (m_ecs_manager->has_component<component::Hierarchy>(entity)) {
-                mark_children_dirty(entity);
-                parent = m_ecs_manager->get_component<component::Hierarchy>(entity).parent;
-            }
+    if (!m_hierarchy_observer->get_matched().empty() || !m_hierarchy_observer->get_unmatched().empty()) {
+        m_hierarchy_observer->clear_changes();
+        m_table_stale = true;
+    }
 
-            if (parent != ecs::MAX_ENTITIES) {
-                const glm::mat4& parent_matrix = m_ecs_manager->get_component<component::Transform>(parent).
-                        world_matrix;
-                update_world_matrix(transform, parent_matrix);
+    auto& transforms = m_ecs_manager->get_component_array<component::Transform>();
+    transforms.each_changed(
+        m_last_change_tick,
+        [this](const ecs::Entity entity, component::Transform& transform) {
+            update_local_matrix(transform); // (descendants updated along with a changed entity reuse theirs)
+            if (m_table_stale) {
+                return; // (the rebuilt table takes the cached matrix)
             }
-            else {
-                update_world_matrix(transform, glm::mat4(1.0f));
+            if (const auto row = m_table.find_row(entity) ; row != TransformTable::k_no_row) {
+                m_table.set_local_matrix(row, transform.local_matrix);
             }
+        });
+    m_last_change_tick = tick;
 
-            transform.dirty = false;
-        }
+    if (m_table_stale) {
+        rebuild_table();
+    }
+
+    for (const auto row : m_table.propagate()) {
+        get_transform(row).world_matrix = m_table.get_world_matrix(row);
     }
 }
 
-void TransformSystem::on_entity_added(const ecs::Entity entity) {}
+void TransformSystem::on_entity_added(const ecs::Entity entity)
+{
+    m_table_stale = true;
+}
 
-void TransformSystem::on_entity_removed(const ecs::Entity entity) {}
+void TransformSystem::on_entity_removed(const ecs::Entity entity)
+{
+    m_table_stale = true;
+}
 
-void TransformSystem::mark_children_dirty(const ecs::Entity parent)
+void TransformSystem::update_local_matrix(component::Transform& transform)
 {
-    auto& parent_hierarchy = m_ecs_manager->get_component<component::Hierarchy>(parent);
-    for (const auto& child : parent_hierarchy.children) {
-        if (m_ecs_manager->has_component<component::Transform>(child)) {
-            auto& child_transform = m_ecs_manager->get_component<component::Transform>(child);
-            child_transform.dirty = true;
-        }
-        mark_children_dirty(child);
+    // translation * rotation * scale, written out: the rotation's columns scaled, the translation appended
+    const glm::mat3 rotation = glm::mat3_cast(transform.rotation);
+
+    transform.local_matrix[0] = glm::vec4(rotation[0] * transform.scale.x, 0.0f);
+    transform.local_matrix[1] = glm::vec4(rotation[1] * transform.scale.y, 0.0f);
+    transform.local_matrix[2] = glm::vec4(rotation[2] * transform.scale.z, 0.0f);
+    transform.local_matrix[3] = glm::vec4(transform.translation, 1.0f);
+}
+
+component::Transform& TransformSystem::get_transform(const std::uint32_t row)
+{
+    auto&             transforms = m_ecs_manager->get_component_array<component::Transform>();
+    const ecs::Entity entity     = m_table.get_entity(row);
+
+    std::uint32_t index = m_table.get_component_index(row);
+    if (index >= transforms.size() || transforms.get_entities()[index] != entity) {
+        index = static_cast<std::uint32_t>(transforms.get_index(entity)); // (moved by a removal or a group)
+        m_table.set_component_index(row, index);
     }
+    return transforms.get_data_at(index);
 }
 
-void TransformSystem::update_world_matrix(component::Transform& transform, const glm::mat4& parent_matrix)
+void TransformSystem::rebuild_table()
 {
-    auto local_matrix = glm::mat4(1.0f);
-    local_matrix      = glm::scale(local_matrix, transform.scale);
-    local_matrix      = glm::translate(local_matrix, transform.translation);
-    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-    local_matrix      = glm::rotate(local_matrix, glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-
-    transform.world_matrix = parent_matrix * local_matrix;
+    m_table_stale = false;
+    m_table.clear();
+
+    // dense index of every transform, by entity index (one pass over the array rather than a lookup per entity)
+    auto&       transforms = m_ecs_manager->get_component_array<component::Transform>();
+    const auto& entities   = transforms.get_entities();
+    for (std::size_t index = 0 ; index < transforms.size() ; ++index) {
+        const std::uint32_t entity_index = ecs::get_entity_index(entities[index]);
+        if (entity_index >= m_component_indices.size()) {
+            m_component_indices.resize(entity_index + 1);
+        }
+        m_component_indices[entity_index] = static_cast<std::uint32_t>(index);
+    }
+
+    // nodes in the hierarchy's order (parents first), below their parent's row; nodes whose parent has no
+    // transform are roots
+    if (m_hierarchy_system != nullptr) {
+        for (const auto entity : m_hierarchy_system->get_order()) {
+            const std::uint32_t entity_index = ecs::get_entity_index(entity);
+            if (entity_index >= m_component_indices.size()) {
+                continue;
+            }
+            const std::uint32_t index = m_component_indices[entity_index];
+            if (index >= transforms.size() || entities[index] != entity) {
+                continue; // (no transform)
+            }
+
+            const ecs::Entity parent     = m_hierarchy_system->get_parent(entity);
+            std::uint32_t     parent_row = TransformTable::k_no_parent;
+            if (parent != ecs::NULL_ENTITY) {
+                if (const auto row = m_table.find_row(parent) ; row != TransformTable::k_no_row) {
+                    parent_row = row;
+                }
+            }
+            m_table.push(entity, parent_row, transforms.get_data_at(index).local_matrix, index);
+        }
+    }
+
+    // transforms outside the hierarchy
+    for (std::size_t index = 0 ; index < transforms.size() && m_table.size() < transforms.size() ; ++index) {
+        if (m_table.find_row(entities[index]) == TransformTable::k_no_row) {
+            m_table.push(entities[index], TransformTable::k_no_parent, transforms.get_data_at(index).local_matrix,
+                         static_cast<std::uint32_t>(index));
+        }
+    }
 }
 }
@@ -0,0 +1,92 @@
+// Copyright © 2024 Jacob Curlin
+
+#include "core/transform_table.h"
+
+#include <algorithm>
+
+namespace cgx::core
+{
+void TransformTable::clear()
+{
+    std::fill(m_rows.begin(), m_rows.end(), k_no_row);
+
+    m_entities.clear();
+    m_parents.clear();
+    m_local_matrices.clear();
+    m_world_matrices.clear();
+    m_dirty.clear();
+    m_component_indices.clear();
+    m_first_dirty = k_no_row;
+}
+
+std::uint32_t TransformTable::push(const ecs::Entity entity, const std::uint32_t parent, const glm::mat4& local_matrix,
+                                   const std::uint32_t component_index)
+{
+    const auto row = static_cast<std::uint32_t>(m_entities.size());
+    CGX_ASSERT(parent == k_no_parent || parent < row, "Transform table rows must follow their parent's.");
+
+    const std::uint32_t index = ecs::get_entity_index(entity);
+    if (index >= m_rows.size()) {
+        m_rows.resize(index + 1, k_no_row);
+    }
+    m_rows[index] = row;
+
+    m_entities.push_back(entity);
+    m_parents.push_back(parent);
+    m_local_matrices.push_back(local_matrix);
+    m_world_matrices.emplace_back(1.0f);
+    m_dirty.push_back(1);
+    m_component_indices.push_back(component_index);
+    m_first_dirty = std::min(m_first_dirty, row);
+    return row;
+}
+
+std::uint32_t TransformTable::find_row(const ecs::Entity entity) const
+{
+    const std::uint32_t index = ecs::get_entity_index(entity);
+    if (index >= m_rows.size() || m_rows[index] == k_no_row || m_entities[m_rows[index]] != entity) {
+        return k_no_row;
+    }
+    return m_rows[index];
+}
+
+void TransformTable::set_local_matrix(const std::uint32_t row, const glm::mat4& local_matrix)
+{
+    m_local_matrices[row] = local_matrix;
+    m_dirty[row]          = 1;
+    m_first_dirty         = std::min(m_first_dirty, row);
+}
+
+const std::vector<std::uint32_t>& TransformTable::propagate()
+{
+    m_updated_rows.clear();
+    if (m_first_dirty == k_no_row) {
+        return m_updated_rows; // (nothing changed: a static scene costs nothing per step)
+    }
+
+    const std::size_t row_count = m_entities.size();
+    for (std::size_t row = m_first_dirty ; row < row_count ; ++row) {
+        const std::uint32_t parent = m_parents[row];
+        if (parent == k_no_parent) {
+            if (m_dirty[row]) {
+                m_world_matrices[row] = m_local_matrices[row];
+                m_updated_rows.push_back(static_cast<std::uint32_t>(row));
+            }
+            continue;
+        }
+
+        // (parents precede children, so a parent's flag & world matrix are final by now)
+        m_dirty[row] |= m_dirty[parent];
+        if (m_dirty[row]) {
+            m_world_matrices[row] = m_world_matrices[parent] * m_local_matrices[row];
+            m_updated_rows.push_back(static_cast<std::uint32_t>(row));
+        }
+    }
+
+    for (const auto row : m_updated_rows) {
+        m_dirty[row] = 0;
+    }
+    m_first_dirty = k_no_row;
+    return m_updated_rows;
+}
+}
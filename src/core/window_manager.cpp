@@ -18,17 +18,17 @@ WindowManager::WindowManager(const uint32_t width, const uint32_t height, std::s
     init();
 
     auto& event_handler = EventHandler::get_instance();
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::ACTIVATE_GUI_CONTROL_MODE,
         [this](event::Event& event) {
             this->enable_cursor();
-        });
+        }));
 
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         event::master::ACTIVATE_GAME_CONTROL_MODE,
         [this](event::Event& event) {
             this->disable_cursor();
-        });
+        }));
 }
 
 WindowManager::~WindowManager()
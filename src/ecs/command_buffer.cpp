@@ -0,0 +1,69 @@
+// Copyright © 2024 Jacob Curlin
+
+#include "ecs/command_buffer.h"
+
+namespace cgx::ecs
+{
+CommandBuffer::CommandBuffer(ECSManager* ecs_manager)
+    : m_ecs_manager(ecs_manager) {}
+
+CommandBuffer::~CommandBuffer() = default;
+
+Entity CommandBuffer::acquire_entity() const
+{
+    std::lock_guard lock(m_record_mutex);
+    return m_ecs_manager->acquire_entity();
+}
+
+void CommandBuffer::release_entity(const Entity entity)
+{
+    std::lock_guard lock(m_record_mutex);
+    m_commands.push_back({CommandType::ReleaseEntity, entity, 0, nullptr});
+}
+
+void CommandBuffer::flush()
+{
+    while (!m_commands.empty()) {
+        apply_commands();
+        update_systems(); // (may record further commands)
+    }
+}
+
+void CommandBuffer::apply_commands()
+{
+    // index-based; releasing an entity updates system membership immediately, which may record further commands
+    for (std::size_t i = 0 ; i < m_commands.size() ; ++i) {
+        const Command command = m_commands[i];
+        if (!m_ecs_manager->is_valid(command.entity)) {
+            continue;
+        }
+
+        switch (command.type) {
+            case CommandType::AddComponent: {
+                command.staging->add(*m_ecs_manager, command.entity, command.staged_index);
+                break;
+            }
+            case CommandType::RemoveComponent: {
+                command.staging->remove(*m_ecs_manager, command.entity);
+                break;
+            }
+            case CommandType::ReleaseEntity: {
+                m_ecs_manager->release_entity(command.entity);
+                break;
+            }
+        }
+    }
+
+    m_commands.clear();
+    for (const auto& staging : m_stagings) {
+        if (staging) {
+            staging->clear();
+        }
+    }
+}
+
+void CommandBuffer::update_systems() const
+{
+    m_ecs_manager->m_system_registry->update_membership();
+}
+}
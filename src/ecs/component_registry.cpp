@@ -2,17 +2,81 @@
 
 #include "ecs/component_registry.h"
 
+#include <array>
+
 namespace cgx::ecs
 {
 ComponentRegistry::ComponentRegistry() = default;
 ComponentRegistry::~ComponentRegistry() = default;
 
-void ComponentRegistry::on_entity_released(const Entity entity) const
+void ComponentRegistry::on_entity_released(const Entity entity, const Signature& signature) const
+{
+    for (ComponentType type = 0 ; type < m_component_arrays.size() ; ++type) {
+        if (signature.test(type)) {
+            m_component_arrays[type]->entity_destroyed(entity);
+        }
+    }
+}
+
+void ComponentRegistry::save(SnapshotWriter& writer) const
+{
+    writer.write(static_cast<std::uint32_t>(m_component_arrays.size()));
+    for (const auto& component_array : m_component_arrays) {
+        const std::size_t section = writer.begin_section();
+        component_array->save(writer);
+        writer.end_section(section);
+    }
+}
+
+bool ComponentRegistry::is_compatible(SnapshotReader reader) const
+{
+    if (reader.read<std::uint32_t>() != m_component_arrays.size()) {
+        return false;
+    }
+    for (const auto& component_array : m_component_arrays) {
+        if (SnapshotReader section = reader.read_section() ; !component_array->is_compatible(section)) {
+            return false;
+        }
+    }
+    return !reader.has_failed();
+}
+
+bool ComponentRegistry::is_loadable(SnapshotReader reader, const EntityRegistry& entities) const
 {
-    for (auto const& pair : m_component_arrays) {
-        auto const& component_array = pair.second;
+    // signatures may only refer to registered types; count each type's owners for the arrays to check against
+    std::array<std::size_t, MAX_COMPONENTS> owner_counts{};
+    for (const auto entity : entities.get_active_entities()) {
+        const Signature signature = entities.get_signature(entity);
+        for (ComponentType type = 0 ; type < MAX_COMPONENTS ; ++type) {
+            if (!signature.test(type)) {
+                continue;
+            }
+            if (type >= m_component_arrays.size()) {
+                return false;
+            }
+            ++owner_counts[type];
+        }
+    }
 
-        component_array->entity_destroyed(entity);
+    if (reader.read<std::uint32_t>() != m_component_arrays.size()) {
+        return false;
+    }
+    for (ComponentType type = 0 ; type < m_component_arrays.size() ; ++type) {
+        const SnapshotReader section = reader.read_section();
+        if (!m_component_arrays[type]->is_loadable(section, entities, type, owner_counts[type])) {
+            return false;
+        }
+    }
+    return reader.is_complete();
+}
+
+void ComponentRegistry::load(SnapshotReader& reader)
+{
+    const auto type_count = reader.read<std::uint32_t>();
+    CGX_ASSERT(type_count == m_component_arrays.size(), "Snapshot holds a different set of component types.");
+    for (const auto& component_array : m_component_arrays) {
+        SnapshotReader section = reader.read_section();
+        component_array->load(section);
     }
 }
 }
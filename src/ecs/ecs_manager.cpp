@@ -1,14 +1,28 @@
 // Copyright © 2024 Jacob Curlin
 
 #include "ecs/ecs_manager.h"
+#include "ecs/command_buffer.h"
+#include "ecs/snapshot.h"
+
+#include <fstream>
 
 namespace cgx::ecs
 {
-    ECSManager::ECSManager()
+    namespace
+    {
+        constexpr std::uint32_t k_snapshot_magic   = 0x53584743; // "CGXS"
+        constexpr std::uint32_t k_snapshot_version = 1;
+    }
+
+    ECSManager::ECSManager(core::JobSystem* job_system)
+        : m_job_system(job_system)
     {
+        CGX_ASSERT(job_system, "ECSManager requires a job system.");
+
         m_entity_registry = std::make_unique<EntityRegistry>();
         m_component_registry = std::make_unique<ComponentRegistry>();
-        m_system_registry = std::make_unique<SystemRegistry>(this);
+        m_system_registry = std::make_unique<SystemRegistry>(this, job_system);
+        m_command_buffer = std::make_unique<CommandBuffer>(this);
     }
 
     ECSManager::~ECSManager() = default;
@@ -16,10 +30,96 @@ namespace cgx::ecs
     void ECSManager::frame_update(const float dt) const
     {
         m_system_registry->frame_update(dt);
+        m_command_buffer->flush(); // sync point
+        m_component_registry->advance_change_tick();
     }
 
     void ECSManager::fixed_update(const float dt) const
     {
         m_system_registry->fixed_update(dt);
+        m_command_buffer->flush(); // sync point
+        m_component_registry->advance_change_tick();
+    }
+
+    CommandBuffer& ECSManager::get_command_buffer() const
+    {
+        return *m_command_buffer;
+    }
+
+    bool ECSManager::save_snapshot(const std::filesystem::path& path) const
+    {
+        SnapshotWriter writer;
+        writer.write(k_snapshot_magic);
+        writer.write(k_snapshot_version);
+
+        const std::size_t entity_section = writer.begin_section();
+        m_entity_registry->save(writer);
+        writer.end_section(entity_section);
+
+        const std::size_t component_section = writer.begin_section();
+        m_component_registry->save(writer);
+        writer.end_section(component_section);
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        const auto&   buffer = writer.get_buffer();
+        if (!stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+            CGX_ERROR("ECSManager: failed to write snapshot '{}'", path.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool ECSManager::load_snapshot(const std::filesystem::path& path)
+    {
+        if (m_entity_registry->get_active_entity_count() != 0) {
+            CGX_ERROR("ECSManager: snapshot '{}' can only be loaded into a world without entities", path.string());
+            return false;
+        }
+
+        const MappedFile file(path);
+        if (!file.is_open()) {
+            CGX_ERROR("ECSManager: failed to open snapshot '{}'", path.string());
+            return false;
+        }
+
+        SnapshotReader reader(file.get_data(), file.get_size());
+        if (reader.get_remaining() < 2 * sizeof(std::uint32_t) || reader.read<std::uint32_t>() != k_snapshot_magic
+            || reader.read<std::uint32_t>() != k_snapshot_version) {
+            CGX_ERROR("ECSManager: '{}' isn't a snapshot of this version", path.string());
+            return false;
+        }
+
+        SnapshotReader entity_section    = reader.read_section();
+        SnapshotReader component_section = reader.read_section();
+        if (!m_component_registry->is_compatible(component_section)) {
+            CGX_ERROR("ECSManager: snapshot '{}' holds different component types than registered", path.string());
+            return false;
+        }
+
+        // check the whole snapshot before touching the world: entities go to a separate registry first, which
+        // replaces this world's only once the component sections agree with it
+        auto entity_registry = std::make_unique<EntityRegistry>();
+        if (!entity_registry->load(entity_section)
+            || !m_component_registry->is_loadable(component_section, *entity_registry)) {
+            CGX_ERROR("ECSManager: snapshot '{}' is truncated or corrupt", path.string());
+            return false;
+        }
+
+        m_entity_registry = std::move(entity_registry);
+        m_component_registry->load(component_section);
+
+        // repopulate everything derived from signatures
+        for (const auto entity : m_entity_registry->get_active_entities()) {
+            const auto signature = m_entity_registry->get_signature(entity);
+            for (const auto& group : m_groups) {
+                if (group->matches(signature)) {
+                    group->on_entity_matched(entity);
+                }
+            }
+            notify_observers(entity, Signature{}, signature);
+        }
+        m_system_registry->update_membership();
+
+        return true;
     }
 }
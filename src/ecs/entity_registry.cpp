@@ -6,57 +6,156 @@ namespace cgx::ecs
 {
 
 EntityRegistry::EntityRegistry()
-    : m_active_entity_count(0) // initialize vector of MAX_ENTITIES
-{
-    for (Entity entity = 0 ; entity < MAX_ENTITIES ; ++entity) {
-        m_available_entities.push(entity);
-    }
-}
+    : m_active_entity_count(0) {}
 
 EntityRegistry::~EntityRegistry() = default;
 
-Entity EntityRegistry::acquire_entity() // fetch first unused entity from entity vector
+Entity EntityRegistry::acquire_entity() // reuse the last released slot if available, otherwise mint a new one
 {
-    CGX_ASSERT(m_active_entity_count < MAX_ENTITIES, "Too many active entities.");
-
-    const Entity id = m_available_entities.front(); // fetch
-    m_available_entities.pop();
+    Entity entity;
+    if (m_free_head != ENTITY_INDEX_MASK) {
+        const std::uint32_t index = m_free_head;
+        m_free_head               = get_entity_index(m_handles[index]); // pop
+        entity                    = make_entity(index, get_entity_generation(m_handles[index]));
+        m_handles[index]          = entity;
+    }
+    else {
+        // the last index is reserved so that no live handle can equal NULL_ENTITY; slots retired after their last
+        // generation count against the index space too (see get_retired_count)
+        CGX_ASSERT(m_handles.size() < ENTITY_INDEX_MASK,
+                   "Entity index space exhausted by live & retired slots (see ECSManager::reclaim_retired_entities).");
+
+        entity = make_entity(static_cast<std::uint32_t>(m_handles.size()), 0);
+        m_handles.push_back(entity);
+        m_signatures.emplace_back();
+    }
     ++m_active_entity_count;
 
-    return id;
+    return entity;
 }
 
-void EntityRegistry::release_entity(Entity entity)
+void EntityRegistry::release_entity(const Entity entity)
 {
-    CGX_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+    CGX_ASSERT(is_valid(entity), "Releasing invalid or stale entity.");
 
-    m_signatures[entity].reset(); // reset entity's signature (bitset)
+    const std::uint32_t index = get_entity_index(entity);
 
-    m_available_entities.push(entity);
+    m_signatures[index].reset(); // reset entity's signature (bitset)
+
+    if (get_entity_generation(entity) == ENTITY_GENERATION_MASK) {
+        m_handles[index] = NULL_ENTITY; // retire (the next generation would wrap)
+        ++m_retired_count;
+    }
+    else {
+        m_handles[index] = make_entity(m_free_head, get_entity_generation(entity) + 1); // push
+        m_free_head      = index;
+    }
 
     --m_active_entity_count;
 }
 
+bool EntityRegistry::is_valid(const Entity entity) const
+{
+    const std::uint32_t index = get_entity_index(entity);
+    return index < m_handles.size() && m_handles[index] == entity;
+}
+
 void EntityRegistry::set_signature(const Entity entity, const Signature signature)
 {
-    CGX_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+    CGX_ASSERT(is_valid(entity), "Invalid or stale entity.");
+
+    m_signatures[get_entity_index(entity)] = signature;
+}
+
+Signature EntityRegistry::get_signature(const Entity entity) const
+{
+    CGX_ASSERT(is_valid(entity), "Invalid or stale entity.");
+
+    return m_signatures[get_entity_index(entity)];
+}
+
+void EntityRegistry::save(SnapshotWriter& writer) const
+{
+    std::vector<std::uint32_t> signatures;
+    signatures.reserve(m_signatures.size());
+    for (const auto& signature : m_signatures) {
+        signatures.push_back(static_cast<std::uint32_t>(signature.to_ulong()));
+    }
 
-    m_signatures[entity] = signature;
+    writer.write_vector(m_handles);
+    writer.write_vector(signatures);
+    writer.write(m_free_head);
+    writer.write(m_active_entity_count);
 }
 
-Signature EntityRegistry::get_signature(const Entity entity)
+bool EntityRegistry::load(SnapshotReader& reader)
 {
-    CGX_ASSERT(entity < MAX_ENTITIES, "Entity out of range.");
+    auto       handles             = reader.read_vector<Entity>();
+    const auto signatures          = reader.read_vector<std::uint32_t>();
+    const auto free_head           = reader.read<std::uint32_t>();
+    const auto active_entity_count = reader.read<std::uint32_t>();
+
+    if (!reader.is_complete() || signatures.size() != handles.size() || handles.size() > ENTITY_INDEX_MASK) {
+        return false;
+    }
+
+    // every slot is either live (its handle's index bits are its own index), retired or released (both with an
+    // empty signature); released slots must form one acyclic free-list starting at 'free_head'
+    std::uint32_t live_count    = 0;
+    std::uint32_t retired_count = 0;
+    for (std::uint32_t index = 0 ; index < handles.size() ; ++index) {
+        if (get_entity_index(handles[index]) == index) {
+            ++live_count;
+        }
+        else if (signatures[index] != 0) {
+            return false;
+        }
+        else if (handles[index] == NULL_ENTITY) {
+            ++retired_count;
+        }
+    }
+    if (live_count != active_entity_count) {
+        return false;
+    }
 
-    return m_signatures[entity];
+    const std::uint32_t released_count = static_cast<std::uint32_t>(handles.size()) - live_count - retired_count;
+    std::uint32_t       free_count     = 0;
+    for (std::uint32_t index = free_head ; index != ENTITY_INDEX_MASK ; index = get_entity_index(handles[index])) {
+        if (index >= handles.size() || get_entity_index(handles[index]) == index || handles[index] == NULL_ENTITY
+            || ++free_count > released_count) {
+            return false;
+        }
+    }
+    if (free_count != released_count) {
+        return false;
+    }
+
+    m_handles = std::move(handles);
+    m_signatures.assign(signatures.begin(), signatures.end());
+    m_free_head           = free_head;
+    m_active_entity_count = active_entity_count;
+    m_retired_count       = retired_count;
+    return true;
+}
+
+void EntityRegistry::reclaim_retired()
+{
+    for (std::uint32_t index = 0 ; index < m_handles.size() && m_retired_count > 0 ; ++index) {
+        if (m_handles[index] == NULL_ENTITY) {
+            m_handles[index] = make_entity(m_free_head, 0); // push
+            m_free_head      = index;
+            --m_retired_count;
+        }
+    }
 }
 
 std::vector<Entity> EntityRegistry::get_active_entities() const
 {
     std::vector<Entity> active_entities;
-    for (Entity entity = 0 ; entity < MAX_ENTITIES ; ++entity) {
-        if (m_signatures[entity].any()) {
-            active_entities.push_back(entity);
+    active_entities.reserve(m_active_entity_count);
+    for (std::uint32_t index = 0 ; index < m_handles.size() ; ++index) {
+        if (get_entity_index(m_handles[index]) == index) {
+            active_entities.push_back(m_handles[index]);
         }
     }
     return active_entities;
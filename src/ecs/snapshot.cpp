@@ -0,0 +1,57 @@
+// Copyright © 2024 Jacob Curlin
+
+#include "ecs/snapshot.h"
+
+#include <fstream>
+
+#if defined(__APPLE__) || defined(__linux__)
+#define CGX_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cgx::ecs
+{
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#if defined(CGX_SNAPSHOT_MMAP)
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return;
+    }
+
+    struct stat status{};
+    if (::fstat(file, &status) == 0 && status.st_size > 0) {
+        void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping != MAP_FAILED) {
+            m_data = static_cast<const std::byte*>(mapping);
+            m_size = static_cast<std::size_t>(status.st_size);
+        }
+    }
+    ::close(file); // (the mapping stays valid)
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        return;
+    }
+
+    m_fallback.resize(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!m_fallback.empty() && stream.read(reinterpret_cast<char*>(m_fallback.data()), m_fallback.size())) {
+        m_data = m_fallback.data();
+        m_size = m_fallback.size();
+    }
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(CGX_SNAPSHOT_MMAP)
+    if (m_data != nullptr) {
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+#endif
+}
+}
@@ -3,57 +3,218 @@
 #include "ecs/system_registry.h"
 #include "ecs/system.h"
 #include "ecs/ecs_manager.h"
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <chrono>
 
 namespace cgx::ecs
 {
-SystemRegistry::SystemRegistry(ECSManager* ecs_manager)
-    : m_ecs_manager(ecs_manager) {}
+SystemRegistry::SystemRegistry(ECSManager* ecs_manager, core::JobSystem* job_system)
+    : m_ecs_manager(ecs_manager)
+    , m_job_system(job_system) {}
 
 SystemRegistry::~SystemRegistry() = default;
 
 void SystemRegistry::frame_update(const float dt)
 {
-    for (auto& [type_id, system] : m_systems) {
-        system->frame_update(dt);
-    }
+    run_phase(Phase::Frame, dt);
 }
 
 void SystemRegistry::fixed_update(const float fixed_dt)
 {
-    for (auto& [type_id, system] : m_systems) {
-        system->fixed_update(fixed_dt);
+    run_phase(Phase::Fixed, fixed_dt);
+}
+
+void SystemRegistry::update_membership()
+{
+    while (!m_changed_observers.empty()) {
+        // (taken out, as systems reacting to their changes may record new ones; those are applied by the next pass,
+        // or by a nested call)
+        std::vector<Observer*> observers;
+        observers.swap(m_changed_observers);
+        if (observers.size() > 1) {
+            std::sort(observers.begin(), observers.end(), [this](const Observer* a, const Observer* b) {
+                return m_observer_systems.at(a) < m_observer_systems.at(b);
+            });
+        }
+
+        for (Observer* observer : observers) {
+            update_membership(*m_systems[m_observer_systems.at(observer)].system, *observer);
+        }
+
+        if (m_changed_observers.empty()) {
+            observers.clear();
+            m_changed_observers.swap(observers); // (keeps its capacity)
+        }
     }
 }
 
-void SystemRegistry::on_entity_released(const Entity entity) const
+std::vector<SystemTiming> SystemRegistry::get_timings() const
 {
-    CGX_TRACE("SystemManager :: EntityDestroyed Called.");
-    for (auto const& pair : m_systems) {
-        auto const& system = pair.second;
+    std::vector<SystemTiming> timings;
+    timings.reserve(m_systems.size());
+    for (const auto& entry : m_systems) {
+        timings.push_back({entry.name, entry.frame_update_ms, entry.fixed_update_ms});
+    }
+    return timings;
+}
 
-        system->on_entity_removed(entity);
-        system->m_entities.erase(entity);
+void SystemRegistry::set_signature(SystemEntry& entry, const Signature signature)
+{
+    CGX_ASSERT(entry.observer == nullptr, "System signature set more than once.");
+
+    entry.observer = &m_ecs_manager->register_observer(signature, Signature{});
+    m_observer_systems.insert({entry.observer, static_cast<std::size_t>(&entry - m_systems.data())});
+    entry.observer->set_change_list(&m_changed_observers);
+    update_membership();
+}
+
+void SystemRegistry::update_membership(System& system, Observer& observer)
+{
+    // the observer's changes, filtered down to the entities whose membership they actually change (the
+    // observer's buffers start over, so changes recorded by the reactions below queue it again)
+    std::vector<Entity> removed;
+    std::vector<Entity> added;
+    removed.swap(observer.m_unmatched);
+    added.swap(observer.m_matched);
+    std::erase_if(removed, [&](const Entity entity) {
+        return observer.contains(entity) || system.m_entities.erase(entity) == 0;
+    });
+    std::erase_if(added, [&](const Entity entity) {
+        return !observer.contains(entity) || !system.m_entities.insert(entity).second;
+    });
+
+    if (removed.size() == 1) {
+        system.on_entity_removed(removed.front());
+    }
+    else if (!removed.empty()) {
+        system.on_entities_removed(removed);
+    }
+    if (added.size() == 1) {
+        system.on_entity_added(added.front());
+    }
+    else if (!added.empty()) {
+        system.on_entities_added(added);
+    }
+
+    // hand the buffers back (keeping their capacity) unless the reactions recorded new changes meanwhile
+    removed.clear();
+    added.clear();
+    if (observer.m_unmatched.empty()) {
+        observer.m_unmatched.swap(removed);
+    }
+    if (observer.m_matched.empty()) {
+        observer.m_matched.swap(added);
     }
 }
 
-void SystemRegistry::on_entity_updated(const Entity entity, const Signature entitySignature)
+void SystemRegistry::build_schedule()
 {
-    for (auto const& pair : m_systems) {
-        auto const& type             = pair.first;
-        auto const& system           = pair.second;
-        auto const& system_signature = m_signatures[type];
+    const std::size_t system_count = m_systems.size();
+    for (auto& entry : m_systems) {
+        entry.dependents.clear();
+        entry.dependency_count = 0;
+    }
+
+    // a later system waits on an earlier one if either writes a component type the other accesses
+    for (std::size_t later = 0 ; later < system_count ; ++later) {
+        for (std::size_t earlier = 0 ; earlier < later ; ++earlier) {
+            const auto& a = m_systems[earlier];
+            const auto& b = m_systems[later];
 
-        if ((entitySignature & system_signature) == system_signature) {
-            if (system->m_entities.insert(entity).second) {
-                system->on_entity_added(entity);
+            const bool conflict = a.exclusive || b.exclusive
+                                  || (a.writes & (b.reads | b.writes)).any()
+                                  || (b.writes & a.reads).any();
+            if (conflict) {
+                m_systems[earlier].dependents.push_back(later);
+                ++m_systems[later].dependency_count;
             }
         }
+    }
+
+    m_pending_dependencies = std::make_unique<std::atomic<std::size_t>[]>(system_count);
+    m_schedule_dirty       = false;
+}
 
-        else {
-            if (system->m_entities.erase(entity) > 0) {
-                system->on_entity_removed(entity);
+void SystemRegistry::run_phase(const Phase phase, const float dt)
+{
+    if (m_schedule_dirty) {
+        build_schedule();
+    }
+    if (m_systems.empty()) {
+        return;
+    }
+
+    for (std::size_t i = 0 ; i < m_systems.size() ; ++i) {
+        m_pending_dependencies[i].store(m_systems[i].dependency_count, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard lock(m_run_mutex);
+        m_remaining_systems = m_systems.size();
+    }
+
+    for (std::size_t i = 0 ; i < m_systems.size() ; ++i) {
+        if (m_systems[i].dependency_count == 0) {
+            dispatch_system(i, phase, dt);
+        }
+    }
+
+    // run systems handed to the calling thread until every system of the phase has finished
+    while (true) {
+        std::size_t index;
+        {
+            std::unique_lock lock(m_run_mutex);
+            m_run_condition.wait(lock, [this] { return !m_calling_thread_queue.empty() || m_remaining_systems == 0; });
+            if (m_calling_thread_queue.empty()) {
+                break;
             }
+            index = m_calling_thread_queue.front();
+            m_calling_thread_queue.pop_front();
+        }
+        run_system(index, phase, dt);
+    }
+}
+
+void SystemRegistry::dispatch_system(const std::size_t index, const Phase phase, const float dt)
+{
+    if (m_systems[index].exclusive || m_job_system->get_worker_count() == 0) {
+        {
+            std::lock_guard lock(m_run_mutex);
+            m_calling_thread_queue.push_back(index);
+        }
+        m_run_condition.notify_all();
+        return;
+    }
+    m_job_system->submit([this, index, phase, dt] { run_system(index, phase, dt); });
+}
+
+void SystemRegistry::run_system(const std::size_t index, const Phase phase, const float dt)
+{
+    using clock = std::chrono::steady_clock;
+
+    auto&      entry = m_systems[index];
+    const auto start = clock::now();
+
+    if (phase == Phase::Frame) {
+        entry.system->frame_update(dt);
+    }
+    else {
+        entry.system->fixed_update(dt);
+    }
+
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    (phase == Phase::Frame ? entry.frame_update_ms : entry.fixed_update_ms) = elapsed_ms;
+
+    for (const auto dependent : entry.dependents) {
+        if (m_pending_dependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            dispatch_system(dependent, phase, dt);
         }
     }
+
+    std::lock_guard lock(m_run_mutex);
+    if (--m_remaining_systems == 0) {
+        m_run_condition.notify_all();
+    }
 }
 }
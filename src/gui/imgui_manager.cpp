@@ -97,23 +97,23 @@ void ImGuiManager::register_event_handlers()
     auto& event_handler = core::EventHandler::get_instance();
     // auto& input_manager = core::InputManager::get_instance();
 
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         core::event::master::TOGGLE_INTERFACE_MODE,
         [this](core::event::Event& event) {
             m_interface_enabled = !m_interface_enabled;
-        });
+        }));
 
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         core::event::master::ACTIVATE_GUI_CONTROL_MODE,
         [this](core::event::Event& event) {
             this->enable_imgui_input();
-        });
+        }));
 
-    event_handler.add_listener(
+    m_subscriptions.push_back(event_handler.add_listener(
         core::event::master::ACTIVATE_GAME_CONTROL_MODE,
         [this](core::event::Event& event) {
             this->disable_imgui_input();
-        });
+        }));
 }
 
 void ImGuiManager::register_panel(std::unique_ptr<ImGuiPanel> panel)
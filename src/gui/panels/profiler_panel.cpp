@@ -3,7 +3,11 @@
 #include "gui/panels/profiler_panel.h"
 #include "gui/imgui_manager.h"
 
+#include "core/event_handler.h"
 #include "core/systems/time_system.h"
+#include "ecs/ecs_manager.h"
+
+#include <algorithm>
 
 namespace cgx::gui
 {
@@ -22,6 +26,75 @@ void ProfilerPanel::render()
     ImGui::Text("Average Frame Time: %u ms", m_average_frame_time);
     ImGui::Text("Total Uptime: %.2f seconds", m_total_uptime);
     ImGui::Text("Total Frames Rendered: %llu", m_total_frame_count);
+
+    ImGui::Separator();
+    if (ImGui::BeginTable("SystemTimingsTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("System");
+        ImGui::TableSetupColumn("Frame (ms)");
+        ImGui::TableSetupColumn("Fixed (ms)");
+        ImGui::TableHeadersRow();
+
+        for (const auto& timing : m_context->get_ecs_manager()->get_system_timings()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(timing.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", timing.frame_update_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", timing.fixed_update_ms);
+        }
+        ImGui::EndTable();
+    }
+
+    render_event_profiles();
+}
+
+void ProfilerPanel::render_event_profiles()
+{
+    ImGui::Separator();
+    if (!core::k_event_profiling) {
+        ImGui::TextDisabled("Event profiling disabled (build with CGX_EVENT_PROFILING)");
+        return;
+    }
+
+    auto& event_handler = core::EventHandler::get_instance();
+    if (ImGui::Button("Reset Event Timings")) {
+        event_handler.reset_listener_profiles();
+    }
+
+    auto profiles = event_handler.get_listener_profiles();
+    std::sort(profiles.begin(), profiles.end(), [](const auto& a, const auto& b) {
+        return a.stats.total_ns > b.stats.total_ns;
+    });
+
+    if (ImGui::BeginTable("EventTimingsTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Event");
+        ImGui::TableSetupColumn("Listener");
+        ImGui::TableSetupColumn("Dispatches");
+        ImGui::TableSetupColumn("Total (ms)");
+        ImGui::TableSetupColumn("Max (ms)");
+        ImGui::TableHeadersRow();
+
+        for (const auto& profile : profiles) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(profile.event.c_str());
+            ImGui::TableNextColumn();
+            if (profile.batch) {
+                ImGui::Text("%s (batch)", profile.listener.c_str());
+            }
+            else {
+                ImGui::TextUnformatted(profile.listener.c_str());
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(profile.stats.dispatch_count));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(profile.stats.total_ns) / 1e6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", static_cast<double>(profile.stats.max_ns) / 1e6);
+        }
+        ImGui::EndTable();
+    }
 }
 
 void ProfilerPanel::update()
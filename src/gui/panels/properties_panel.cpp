@@ -415,10 +415,10 @@ void PropertiesPanel::draw_transform_component_editor(const scene::Node* node)
             auto& component = m_context->get_ecs_manager()->get_component<component::Transform>(node->get_entity());
 
             component.translation = glm::vec3(0.0f);
-            component.rotation    = glm::vec3(0.0f);
+            component.rotation    = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
             component.scale       = glm::vec3(1.0f);
-            component.dirty       = true;
-            updated               = true;
+            m_context->get_ecs_manager()->mark_changed<component::Transform>(node->get_entity());
+            updated = true;
         }
         ImGui::EndPopup();
     }
@@ -464,7 +464,11 @@ void PropertiesPanel::draw_transform_component_editor(const scene::Node* node)
             ImGui::Text("Rotation");
             ImGui::TableSetColumnIndex(1);
             ImGui::SetNextItemWidth(-FLT_MIN);
-            updated |= ImGui::InputFloat3("##RotationSlider", &component.rotation[0]);
+            glm::vec3 euler_angles = component.get_euler_angles(); // (rotation is stored as a quaternion)
+            if (ImGui::InputFloat3("##RotationSlider", &euler_angles[0])) {
+                component.set_euler_angles(euler_angles);
+                updated = true;
+            }
 
             /*
             ImGui::PushStyleColor(ImGuiCol_Button, ImVec4{ 0.8f, 0.1f, 0.15f, 1.0f });
@@ -511,7 +515,7 @@ void PropertiesPanel::draw_transform_component_editor(const scene::Node* node)
         }
 
         if (updated) {
-            component.dirty = true;
+            m_context->get_ecs_manager()->mark_changed<component::Transform>(node->get_entity());
         }
 
         ImGui::Separator();
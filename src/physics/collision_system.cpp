@@ -21,16 +21,13 @@ void CollisionSystem::frame_update(float dt) {}
 
 void CollisionSystem::fixed_update(float dt)
 {
-    for (auto& e1 : m_entities) {
-        auto& t1 = get_component<component::Transform>(e1);
-        auto& c1 = get_component<component::Collider>(e1);
+    const auto colliders = m_ecs_manager->view<component::Transform, component::Collider>();
 
-        for (auto& e2 : m_entities) {
+    for (auto [e1, t1, c1] : colliders) {
+        for (auto [e2, t2, c2] : colliders) {
             if (e1 == e2) {
                 continue;
             }
-            auto& t2 = get_component<component::Transform>(e2);
-            auto& c2 = get_component<component::Collider>(e2);
 
             if (check_collision(t1, c1, t2, c2)) {
                 CGX_TRACE("Collision Detected: Entities {} & {}", e1, e2);
@@ -132,13 +129,13 @@ void CollisionSystem::resolve_collision(const ecs::Entity e1, const ecs::Entity
             auto& r1 = get_component<component::RigidBody>(e1);
             t1.translation -= collision_normal * penetration;
             r1.velocity = glm::reflect(r1.velocity, collision_normal) * 0.5f;
-            t1.dirty = true;
+            m_ecs_manager->mark_changed<component::Transform>(e1);
         }
         else if (!is_static2) {
             auto& r2 = get_component<component::RigidBody>(e2);
             t2.translation += collision_normal * penetration;
             r2.velocity = glm::reflect(r2.velocity, -collision_normal) * 0.5f;
-            t2.dirty = true;
+            m_ecs_manager->mark_changed<component::Transform>(e2);
         }
     }
     else {
@@ -149,10 +146,10 @@ void CollisionSystem::resolve_collision(const ecs::Entity e1, const ecs::Entity
         const float r2_factor  = r1.mass / total_mass;
 
         t1.translation += collision_normal * penetration * r1_factor;
-        t1.dirty = true;
+        m_ecs_manager->mark_changed<component::Transform>(e1);
 
         t2.translation += collision_normal * penetration * r2_factor;
-        t2.dirty = true;
+        m_ecs_manager->mark_changed<component::Transform>(e2);
     }
 }
 }
@@ -4,8 +4,16 @@
 #include "core/components/transform.h"
 #include "core/components/rigid_body.h"
 
+#include <glm/gtc/quaternion.hpp>
+
 namespace cgx::physics
 {
+namespace
+{
+// bodies per job; integration is a few ns per body, so chunks stay well above scheduling overhead
+constexpr std::size_t k_integration_grain_size = 2048;
+}
+
 PhysicsSystem::PhysicsSystem(ecs::ECSManager* ecs_manager)
     : System(ecs_manager)
 {}
@@ -19,16 +27,22 @@ void PhysicsSystem::frame_update(const float dt)
 
 void PhysicsSystem::fixed_update(const float dt)
 {
-    for (auto const& entity : m_entities) {
-        auto& rigid_body = get_component<component::RigidBody>(entity);
-        auto& transform  = get_component<component::Transform>(entity);
-
-        transform.translation += rigid_body.velocity * dt;
-        rigid_body.velocity += rigid_body.acceleration * dt;
+    // backed by the transform / rigid body group registered by the engine, so this walks packed columns,
+    // split into page-aligned chunks across the job system
+    auto& transforms = m_ecs_manager->get_component_array<component::Transform>();
+    m_ecs_manager->view<component::Transform, component::RigidBody>().parallel_each(
+        *m_ecs_manager->get_job_system(),
+        k_integration_grain_size,
+        [dt, &transforms](const ecs::Entity entity, component::Transform& transform, component::RigidBody& rigid_body) {
+            transform.translation += rigid_body.velocity * dt;
+            rigid_body.velocity += rigid_body.acceleration * dt;
 
-        transform.rotation += rigid_body.angular_velocity * dt;
-        transform.scale += rigid_body.scale_rate * dt;
-        transform.dirty = true;
-    }
+            if (rigid_body.angular_velocity != glm::vec3(0.0f)) { // (degrees per second, about the world axes)
+                const glm::quat rotation_delta(glm::radians(rigid_body.angular_velocity * dt));
+                transform.rotation = glm::normalize(rotation_delta * transform.rotation);
+            }
+            transform.scale += rigid_body.scale_rate * dt;
+            transforms.mark_changed(entity);
+        });
 }
 }
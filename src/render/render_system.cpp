@@ -194,7 +194,7 @@ void RenderSystem::geometry_pass()
         0.1f,
         100.0f);
 
-    if (m_camera != ecs::MAX_ENTITIES) {
+    if (m_ecs_manager->is_valid(m_camera)) { // (false for NULL_ENTITY & released camera entities)
         auto& camera_c = get_component<component::Camera>(m_camera);
         m_view_mat     = camera_c.view_matrix;
         m_proj_mat     = camera_c.proj_matrix;
@@ -204,14 +204,7 @@ void RenderSystem::geometry_pass()
         m_proj_mat = default_proj;
     }
 
-    for (auto& entity : m_entities) {
-        if (!m_ecs_manager->has_component<component::Render>(entity)) {
-            continue;
-        }
-
-        auto& render_c    = get_component<component::Render>(entity);
-        auto& transform_c = get_component<component::Transform>(entity);
-
+    for (auto [entity, render_c, transform_c] : m_ecs_manager->view<component::Render, component::Transform>()) {
         auto* model = render_c.model.get();
 
         if (model == nullptr) {
@@ -267,14 +260,7 @@ void RenderSystem::lighting_pass()
 
     int light_index = 0;
     m_curr_lights.clear();
-    for (auto& entity : m_entities) {
-        if (!m_ecs_manager->has_component<component::PointLight>(entity)) {
-            continue;
-        }
-
-        const auto& lc = m_ecs_manager->get_component<component::PointLight>(entity);
-        const auto& tc = m_ecs_manager->get_component<component::Transform>(entity);
-
+    for (auto [entity, lc, tc] : m_ecs_manager->view<component::PointLight, component::Transform>()) {
         m_lighting_shader->set_vec3(
             "lights[" + std::to_string(light_index) + "].position",
             glm::vec3(tc.world_matrix[3]));
@@ -288,7 +274,11 @@ void RenderSystem::lighting_pass()
     }
 
     m_lighting_shader->set_int("num_point_lights", light_index);
-    m_lighting_shader->set_vec3("view_pos", m_ecs_manager->get_component<component::Transform>(m_camera).translation);
+    m_lighting_shader->set_vec3(
+        "view_pos",
+        m_ecs_manager->is_valid(m_camera)
+            ? m_ecs_manager->get_component<component::Transform>(m_camera).translation
+            : glm::vec3(0.0f));
 
     render_quad();
     m_output_fb->unbind();
@@ -318,8 +308,8 @@ void RenderSystem::light_mesh_pass()
     m_light_mesh_shader->set_mat4("view", m_view_mat);
 
     for (auto& entity : m_curr_lights) {
-        auto lc = m_ecs_manager->get_component<component::PointLight>(entity);
-        auto tc = m_ecs_manager->get_component<component::Transform>(entity);
+        const auto& lc = m_ecs_manager->get_component<component::PointLight>(entity);
+        const auto& tc = m_ecs_manager->get_component<component::Transform>(entity);
 
         m_light_mesh_shader->set_mat4("model", tc.world_matrix);
         m_light_mesh_shader->set_vec3("light_color", lc.color);
@@ -375,14 +365,7 @@ void RenderSystem::collider_pass()
     //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     m_output_fb->bind();
-    for (auto& entity : m_entities) {
-        if (!m_ecs_manager->has_component<component::Collider>(entity)) {
-            continue;
-        }
-
-        auto& transform_c = m_ecs_manager->get_component<component::Transform>(entity);
-        auto& collider_c  = m_ecs_manager->get_component<component::Collider>(entity);
-
+    for (auto [entity, transform_c, collider_c] : m_ecs_manager->view<component::Transform, component::Collider>()) {
         glm::mat4 scaled_mesh = glm::scale(transform_c.world_matrix, collider_c.size);
 
         m_collider_config.shader->use();
@@ -59,14 +59,11 @@ void Node::handle_parent_update(Hierarchy* old_parent, Hierarchy* new_parent)
     const auto old_parent_node = dynamic_cast<Node*>(old_parent);
     const auto new_parent_node = dynamic_cast<Node*>(new_parent);
 
-    const ecs::Entity old_parent_entity = old_parent_node ? old_parent_node->get_entity() : ecs::MAX_ENTITIES;
-    const ecs::Entity new_parent_entity = new_parent_node ? new_parent_node->get_entity() : ecs::MAX_ENTITIES;
-
-    core::event::Event event(core::event::component::hierarchy::PARENT_UPDATE);
-    event.set_param(core::event::component::hierarchy::CHILD, get_entity());
-    event.set_param(core::event::component::hierarchy::OLD_PARENT, old_parent_entity);
-    event.set_param(core::event::component::hierarchy::NEW_PARENT, new_parent_entity);
-    core::EventHandler::get_instance().send_event(event);
+    const ecs::Entity old_parent_entity = old_parent_node ? old_parent_node->get_entity() : ecs::NULL_ENTITY;
+    const ecs::Entity new_parent_entity = new_parent_node ? new_parent_node->get_entity() : ecs::NULL_ENTITY;
+
+    core::EventHandler::get_instance().enqueue(
+        core::event::component::hierarchy::ParentUpdated{get_entity(), old_parent_entity, new_parent_entity});
 }
 
 ecs::Entity Node::get_entity() const
@@ -10,7 +10,7 @@ namespace cgx::scene
 {
 Scene::Scene(std::string label) : m_label(std::move(label))
 {
-    m_root = std::make_shared<Node>("root", ecs::MAX_ENTITIES, NodeFlag::None);
+    m_root = std::make_shared<Node>("root", ecs::NULL_ENTITY, NodeFlag::None);
     CGX_INFO("scene '{}' : initialized", m_label);
 }
 Scene::~Scene() = default;
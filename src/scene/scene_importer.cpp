@@ -15,6 +15,10 @@
 #include "core/components/transform.h"
 #include "core/components/render.h"
 
+#include "core/event_handler.h"
+#include "core/events/ecs_events.h"
+
+#include "ecs/command_buffer.h"
 #include "ecs/ecs_manager.h"
 
 #include "scene/node.h"
@@ -66,21 +70,35 @@ void SceneImporter::import(const std::string& path, Node* parent)
         return;
     }
 
+    ecs::CommandBuffer commands(m_ecs_manager);
+    std::vector<PendingLink> pending_links;
+
     for (const auto& gltf_node : gltf_model.scenes[gltf_model.defaultScene].nodes) {
-        process_node(gltf_model, gltf_model.nodes[gltf_node], parent);
+        process_node(gltf_model, gltf_model.nodes[gltf_node], parent, commands, pending_links);
     }
+
+    // add every node's components in one batch, then link nodes (parents precede their children)
+    commands.flush();
+    for (const auto& [node, node_parent] : pending_links) {
+        node->set_parent(node_parent);
+    }
+
+    // apply the links now: delivered at PostUpdate, they'd leave the nodes' first world matrices unparented
+    core::EventHandler::get_instance().flush<core::event::component::hierarchy::ParentUpdated>();
 }
 
 void SceneImporter::process_node(
     const tinygltf::Model& gltf_model,
-    const tinygltf::Node&  gltf_node,
-    Node*                  parent)
+    const tinygltf::Node&     gltf_node,
+    Node*                     parent,
+    ecs::CommandBuffer&       commands,
+    std::vector<PendingLink>& pending_links)
 {
 
     NodeFlag flags = NodeFlag::None;
-    auto entity = m_ecs_manager->acquire_entity();
+    auto entity = commands.acquire_entity();
 
-    m_ecs_manager->add_component<component::Hierarchy>(entity, component::Hierarchy{});
+    commands.add_component<component::Hierarchy>(entity, component::Hierarchy{});
     if (gltf_node.camera >= 0) {
         flags = flags | NodeFlag::Camera;
         auto& gltf_camera = gltf_model.cameras[gltf_node.camera];
@@ -102,8 +120,8 @@ void SceneImporter::process_node(
             camera.far_plane  = static_cast<float>(gltf_camera.orthographic.zfar);
         }
 
-        m_ecs_manager->add_component<component::Camera>(entity, camera);
-        m_ecs_manager->add_component<component::Controllable>(entity, component::Controllable{});
+        commands.add_component<component::Camera>(entity, camera);
+        commands.add_component<component::Controllable>(entity, component::Controllable{});
     }
     if (gltf_node.mesh >= 0) {
         flags = flags | NodeFlag::Mesh;
@@ -126,7 +144,7 @@ void SceneImporter::process_node(
 
             component::Render rc{};
             rc.model = model_asset;
-            m_ecs_manager->add_component<component::Render>(entity, rc);
+            commands.add_component<component::Render>(entity, rc);
         }
     }
 
@@ -140,19 +158,11 @@ void SceneImporter::process_node(
     }
 
     if (!gltf_node.rotation.empty()) {
-        glm::quat quaternion(
-            static_cast<float>(gltf_node.rotation[3]),
-            // w
-            static_cast<float>(gltf_node.rotation[0]),
-            // x
-            static_cast<float>(gltf_node.rotation[1]),
-            // y
-            static_cast<float>(gltf_node.rotation[2]) // z
-        );
-
-        glm::vec3 euler_angles = eulerAngles(quaternion);
-        euler_angles           = degrees(euler_angles);
-        transform.rotation               = euler_angles;
+        transform.rotation = glm::quat(
+            static_cast<float>(gltf_node.rotation[3]),  // w
+            static_cast<float>(gltf_node.rotation[0]),  // x
+            static_cast<float>(gltf_node.rotation[1]),  // y
+            static_cast<float>(gltf_node.rotation[2])); // z
     }
 
     if (!gltf_node.scale.empty()) {
@@ -163,19 +173,18 @@ void SceneImporter::process_node(
     }
 
     transform.world_matrix = glm::mat4(1.0f);
-    transform.dirty = true;
 
-    m_ecs_manager->add_component<component::Transform>(entity, transform);
+    commands.add_component<component::Transform>(entity, transform);
 
     std::string tag = !gltf_node.name.empty() ? gltf_node.name : "[Untagged Node]"; // todo: derive tag
 
     const auto node = std::make_shared<Node>(std::move(tag), entity, flags);
-    node->set_parent(parent);
+    pending_links.emplace_back(node, parent);
 
 
     for (const auto& child_node_index : gltf_node.children) {
         const auto& child_gltf_node = gltf_model.nodes[child_node_index];
-        process_node(gltf_model, child_gltf_node, node.get());
+        process_node(gltf_model, child_gltf_node, node.get(), commands, pending_links);
     }
 }
 
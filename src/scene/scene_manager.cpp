@@ -11,6 +11,7 @@
 #include "core/components/camera.h"
 #include "core/components/controllable.h"
 #include "core/components/point_light.h"
+#include "ecs/command_buffer.h"
 #include "ecs/ecs_manager.h"
 
 namespace cgx::scene
@@ -28,28 +29,31 @@ Node* SceneManager::add_node(std::string tag, NodeFlag flags, Node* parent) cons
 {
     static size_t node_count = 0;
     std::string default_tag = "Empty Node";
-    const auto new_entity = m_ecs_manager->acquire_entity();
+    // components are added in one batch, so systems see the node's full signature once
+    ecs::CommandBuffer commands(m_ecs_manager);
+    const auto         new_entity = commands.acquire_entity();
 
     // ! every node gets a hierarchy component
-    m_ecs_manager->add_component<component::Hierarchy>(new_entity, component::Hierarchy{});
+    commands.add_component<component::Hierarchy>(new_entity, component::Hierarchy{});
 
     if (flags != NodeFlag::None) {
         default_tag = "Transform";
-        m_ecs_manager->add_component<component::Transform>(new_entity, component::Transform{});
+        commands.add_component<component::Transform>(new_entity, component::Transform{});
     }
     if (has_flag(flags, NodeFlag::Mesh)) {
         default_tag = "Mesh";
-        m_ecs_manager->add_component<component::Render>(new_entity, component::Render{});
+        commands.add_component<component::Render>(new_entity, component::Render{});
     }
     if (has_flag(flags, NodeFlag::Camera)) {
         default_tag = "Camera";
-        m_ecs_manager->add_component<component::Camera>(new_entity, component::Camera{});
-        m_ecs_manager->add_component<component::Controllable>(new_entity, component::Controllable{});
+        commands.add_component<component::Camera>(new_entity, component::Camera{});
+        commands.add_component<component::Controllable>(new_entity, component::Controllable{});
     }
     if (has_flag(flags, NodeFlag::Light)) {
         default_tag = "Light";
-        m_ecs_manager->add_component<component::PointLight>(new_entity, component::PointLight{});
+        commands.add_component<component::PointLight>(new_entity, component::PointLight{});
     }
+    commands.flush();
 
     const auto new_node = std::make_shared<Node>(tag.empty() ? default_tag : tag, new_entity, flags);
     // if no parent specified, parent = root
@@ -71,16 +75,17 @@ void SceneManager::remove_node_recursive(Node* node) const
 {
     CGX_ASSERT(node, "attempt to recursively remove invalid node");
 
+    // (visits 'node' itself as well as every descendant)
+    std::vector<ecs::Entity> entities;
     node->for_each(
-        [this](core::Hierarchy& hierarchy) -> bool {
+        [&entities](core::Hierarchy& hierarchy) -> bool {
             if (const Node* casted_node = dynamic_cast<Node*>(&hierarchy) ; casted_node) {
-                m_ecs_manager->release_entity(casted_node->get_entity());
+                entities.push_back(casted_node->get_entity());
             }
             return true;
         });
+    m_ecs_manager->release_entities(entities);
 
-    // todo: release entities for recursively removed children
-    m_ecs_manager->release_entity(node->get_entity());
     node->recursive_remove();
 }
 
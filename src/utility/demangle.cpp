@@ -0,0 +1,38 @@
+// Copyright © 2024 Jacob Curlin
+
+#include "utility/demangle.h"
+
+#include <cstdlib>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace cgx::utility
+{
+std::string demangle(const char* type_name)
+{
+    std::string name = type_name;
+#if defined(__GNUG__)
+    int   status    = 0;
+    char* demangled = abi::__cxa_demangle(type_name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+    return name;
+}
+
+std::string get_unqualified_name(const char* type_name)
+{
+    std::string name = demangle(type_name);
+    if (const auto pos = name.rfind("::") ; pos != std::string::npos) {
+        name = name.substr(pos + 2);
+    }
+    else if (const auto space = name.rfind(' ') ; space != std::string::npos) {
+        name = name.substr(space + 1);
+    }
+    return name;
+}
+}
@@ -0,0 +1,73 @@
+// Copyright © 2024 Jacob Curlin
+
+// Minimal check helpers shared by the ecs tests, & the setup their worlds share. Each test executable runs its
+// tests in turn; a failed check reports where it failed & fails the executable, after the remaining tests have
+// run.
+
+#pragma once
+
+#include "core/job_system.h"
+#include "ecs/ecs_manager.h"
+
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+
+namespace cgx::test
+{
+struct Test
+{
+    const char* name;
+    void (*func)();
+};
+
+inline int& get_failure_count()
+{
+    static int failure_count = 0;
+    return failure_count;
+}
+
+inline void check(const bool condition, const char* expression, const char* message, const char* file, const int line)
+{
+    if (!condition) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\nmessage: %s\n", file, line, expression, message);
+        ++get_failure_count();
+    }
+}
+
+// Runs every test & returns the executable's exit code.
+inline int run_tests(const std::initializer_list<Test> tests)
+{
+    for (const auto& test : tests) {
+        const int failure_count = get_failure_count();
+        test.func();
+        std::fprintf(stderr, "%-48s %s\n", test.name, get_failure_count() == failure_count ? "passed" : "FAILED");
+    }
+    return get_failure_count() == 0 ? 0 : 1;
+}
+
+// the job system shared by every world of the executable (no workers: jobs run on the thread waiting for them)
+inline core::JobSystem& get_job_system()
+{
+    static core::JobSystem job_system(0);
+    return job_system;
+}
+
+inline std::unique_ptr<ecs::ECSManager> make_ecs_manager()
+{
+    return std::make_unique<ecs::ECSManager>(&get_job_system());
+}
+
+// Registers system S over the entities holding every one of 'Components' (registered before).
+template<typename S, typename... Components>
+std::shared_ptr<S> register_system(ecs::ECSManager& ecs_manager)
+{
+    const auto     system = ecs_manager.register_system<S>();
+    ecs::Signature signature;
+    (signature.set(ecs_manager.get_component_type<Components>()), ...);
+    ecs_manager.set_system_signature<S>(signature);
+    return system;
+}
+}
+
+#define CGX_CHECK(x, msg) ::cgx::test::check((x), #x, msg, __FILE__, __LINE__)
@@ -0,0 +1,209 @@
+// Copyright © 2024 Jacob Curlin
+
+// Tests the event handler's typed channels & listener lists. Tests share the event handler singleton, so each
+// one sends its own event type & drops its subscriptions before returning.
+
+#include "test.h"
+
+#include "core/event_handler.h"
+#include "core/job_system.h"
+#include "core/events/ecs_events.h"
+#include "core/listener_list.h"
+
+#include <atomic>
+#include <functional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace cgx::test
+{
+namespace
+{
+// an id recycled from an inactive (not yet compacted) entry must keep addressing its own listener
+void test_listener_id_reuse()
+{
+    core::ListenerList<std::function<void()>> listeners;
+    std::size_t                                calls = 0;
+
+    const auto a = listeners.add([] {});
+    auto       b = listeners.add([] {});
+    const auto c = listeners.add([] {});
+    const auto d = listeners.add([] {});
+    b.reset();
+
+    auto e = listeners.add([&] { ++calls; }, core::ListenerAffinity::MainThread, 5);
+    e.reset();
+    listeners.dispatch([](const auto& entry) { entry.func(); });
+
+    CGX_CHECK(calls == 0 && listeners.size() == 3, "Unsubscribed listener still dispatched.");
+}
+
+// parent updates queued for the same child within a frame are delivered as one update, carrying the first
+// old parent & the last new parent
+void test_parent_update_coalescing()
+{
+    using core::event::component::hierarchy::ParentUpdated;
+
+    constexpr std::size_t k_node_count       = 100;
+    constexpr std::size_t k_updates_per_node = 4;
+
+    auto&                      event_handler = core::EventHandler::get_instance();
+    std::vector<ParentUpdated> delivered;
+    const auto                 subscription = event_handler.add_batch_listener<ParentUpdated>(
+        [&](const std::span<const ParentUpdated> events) { delivered.insert(delivered.end(), events.begin(), events.end()); });
+
+    // (the second flush's updates must not merge into the first's)
+    for (std::size_t flush = 0 ; flush < 2 ; ++flush) {
+        delivered.clear();
+        for (std::size_t update = 0 ; update < k_updates_per_node ; ++update) {
+            for (std::size_t node = 0 ; node < k_node_count ; ++node) {
+                event_handler.enqueue(ParentUpdated{static_cast<ecs::Entity>(node + 1), static_cast<ecs::Entity>(update),
+                                                    static_cast<ecs::Entity>(update + 1)});
+            }
+        }
+        event_handler.flush(event_handler.get_channel<ParentUpdated>().get_phase());
+
+        CGX_CHECK(delivered.size() == k_node_count, "Parent updates weren't coalesced per node.");
+        for (std::size_t node = 0 ; node < delivered.size() ; ++node) {
+            CGX_CHECK(delivered[node].child == node + 1 && delivered[node].old_parent == 0
+                      && delivered[node].new_parent == k_updates_per_node, "Coalesced parent update lost its ends.");
+        }
+    }
+}
+
+// profiles name listeners after where they subscribed, including listeners added during the dispatch profiled
+// (built without CGX_EVENT_PROFILING, there are no profiles to check)
+void test_listener_labels()
+{
+    struct LabelledEvent
+    {
+        std::uint32_t value;
+    };
+
+    if constexpr (core::k_event_profiling) {
+        auto&              event_handler = core::EventHandler::get_instance();
+        core::Subscription added;
+        std::size_t        labelled = 0;
+
+        const auto subscription = event_handler.add_listener<LabelledEvent>([&](const LabelledEvent&) {
+            added = event_handler.add_listener<LabelledEvent>([](const LabelledEvent&) {}); // (pending)
+            for (const auto& profile : event_handler.get_listener_profiles()) {
+                labelled += profile.event == "LabelledEvent" && profile.listener.starts_with("event_test.cpp:");
+            }
+        });
+        event_handler.send(LabelledEvent{0});
+
+        CGX_CHECK(labelled == 2, "Listener profiles not labelled by their subscription.");
+    }
+}
+
+// unsubscribing a worker-affinity listener must not return while a job may still invoke it
+void test_worker_listener_removal()
+{
+    struct WorkerEvent
+    {
+        std::uint32_t value;
+    };
+
+    core::JobSystem job_system(0); // (jobs only run when waited on)
+    auto&           event_handler = core::EventHandler::get_instance();
+    event_handler.set_job_system(&job_system);
+
+    std::size_t calls        = 0;
+    auto        subscription = event_handler.add_listener<WorkerEvent>(
+        [&calls](const WorkerEvent&) { ++calls; }, core::ListenerAffinity::Worker);
+    event_handler.send(WorkerEvent{0});
+    subscription.reset();
+
+    CGX_CHECK(calls == 1, "Worker listener jobs outlived its subscription.");
+    event_handler.set_job_system(nullptr);
+}
+
+// events posted from several threads while the main thread flushes arrive exactly once & in order per producer
+void test_post_from_threads()
+{
+    struct PostedEvent
+    {
+        std::uint32_t producer;
+        std::uint32_t sequence;
+    };
+
+    constexpr std::size_t k_event_count = 100'000;
+
+    auto& event_handler = core::EventHandler::get_instance();
+    for (const std::size_t producer_count : {1u, 2u, 4u, 8u}) {
+        std::vector<std::uint32_t> next_sequence(producer_count, 0);
+        std::size_t                received  = 0;
+        bool                       in_order = true;
+
+        const auto subscription = event_handler.add_listener<PostedEvent>([&](const PostedEvent& event) {
+            in_order = in_order && event.sequence == next_sequence[event.producer];
+            ++next_sequence[event.producer];
+            ++received;
+        });
+
+        std::atomic<bool>        start{false};
+        std::vector<std::thread> producers;
+        for (std::size_t producer = 0 ; producer < producer_count ; ++producer) {
+            producers.emplace_back([&, producer] {
+                while (!start.load(std::memory_order_acquire)) {}
+                for (std::size_t i = 0 ; i < k_event_count / producer_count ; ++i) {
+                    event_handler.post(PostedEvent{static_cast<std::uint32_t>(producer), static_cast<std::uint32_t>(i)});
+                }
+            });
+        }
+
+        start.store(true, std::memory_order_release);
+        const std::size_t expected = k_event_count / producer_count * producer_count;
+        while (received < expected) {
+            event_handler.flush(core::EventPhase::PreUpdate);
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        event_handler.flush(core::EventPhase::PreUpdate);
+
+        CGX_CHECK(received == expected, "Posted events delivered more than once.");
+        CGX_CHECK(in_order, "Posted events delivered out of order.");
+    }
+}
+
+// flushing one event type delivers its queued events ahead of their phase, & only once
+void test_type_flush()
+{
+    struct LateEvent
+    {
+        std::uint32_t value;
+    };
+
+    auto&       event_handler = core::EventHandler::get_instance();
+    std::size_t received      = 0;
+    const auto  subscription  = event_handler.add_listener<LateEvent>([&](const LateEvent&) { ++received; });
+
+    event_handler.set_delivery_phase<LateEvent>(core::EventPhase::PostUpdate);
+    event_handler.enqueue(LateEvent{0});
+    event_handler.flush<LateEvent>();
+    CGX_CHECK(received == 1, "Flushed event type not delivered.");
+
+    event_handler.flush(core::EventPhase::PostUpdate);
+    CGX_CHECK(received == 1, "Flushed event delivered again by its phase.");
+
+    event_handler.enqueue(LateEvent{1});
+    event_handler.flush(core::EventPhase::PostUpdate);
+    CGX_CHECK(received == 2, "Event queued after a type flush not delivered by its phase.");
+}
+}
+}
+
+int main()
+{
+    return cgx::test::run_tests({
+        {"event/listener_id_reuse", cgx::test::test_listener_id_reuse},
+        {"event/parent_update_coalescing", cgx::test::test_parent_update_coalescing},
+        {"event/listener_labels", cgx::test::test_listener_labels},
+        {"event/worker_listener_removal", cgx::test::test_worker_listener_removal},
+        {"event/post_from_threads", cgx::test::test_post_from_threads},
+        {"event/type_flush", cgx::test::test_type_flush},
+    });
+}
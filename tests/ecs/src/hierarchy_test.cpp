@@ -0,0 +1,132 @@
+// Copyright © 2024 Jacob Curlin
+
+// Tests the hierarchy system's traversal order: parents precede their children however nodes are added, both
+// when spliced in incrementally & when rebuilt by a batch.
+
+#include "test.h"
+
+#include "core/systems/hierarchy_system.h"
+#include "ecs/ecs_manager.h"
+#include "core/components/hierarchy.h"
+#include "core/components/transform.h"
+
+#include <memory>
+#include <vector>
+
+namespace cgx::test
+{
+namespace
+{
+constexpr std::size_t k_node_count = 1'000;
+constexpr std::size_t k_branching  = 8; // children per node
+
+struct World
+{
+    std::unique_ptr<ecs::ECSManager>       ecs_manager;
+    std::shared_ptr<core::HierarchySystem> hierarchy_system;
+};
+
+World make_world()
+{
+    World world;
+    world.ecs_manager = make_ecs_manager();
+    world.ecs_manager->register_component<component::Hierarchy>();
+    world.ecs_manager->register_component<component::Transform>();
+
+    world.hierarchy_system = register_system<core::HierarchySystem, component::Hierarchy>(*world.ecs_manager);
+    return world;
+}
+
+// adds a tree (children of node n are n * k + 1 ... n * k + k) breadth-first, so most nodes splice into the
+// middle of the order
+std::vector<ecs::Entity> add_tree(World& world)
+{
+    const auto                        nodes = world.ecs_manager->acquire_entities(k_node_count);
+    std::vector<component::Hierarchy> hierarchies(k_node_count);
+    for (std::size_t node = 1 ; node < k_node_count ; ++node) {
+        const std::size_t parent = (node - 1) / k_branching;
+        hierarchies[node].parent = nodes[parent];
+        hierarchies[parent].children.push_back(nodes[node]);
+    }
+    for (std::size_t node = 0 ; node < k_node_count ; ++node) {
+        world.ecs_manager->add_component(nodes[node], hierarchies[node]);
+    }
+    return nodes;
+}
+
+// every node follows the node it's placed below, which is its tree parent
+bool is_parent_first(World& world, const std::vector<ecs::Entity>& nodes)
+{
+    const auto& order = world.hierarchy_system->get_order();
+    if (order.size() != nodes.size()) {
+        return false;
+    }
+
+    std::vector<std::size_t> positions(nodes.size());
+    for (std::size_t position = 0 ; position < order.size() ; ++position) {
+        positions[ecs::get_entity_index(order[position]) - ecs::get_entity_index(nodes[0])] = position;
+    }
+    for (std::size_t node = 1 ; node < nodes.size() ; ++node) {
+        const std::size_t parent = (node - 1) / k_branching;
+        if (world.hierarchy_system->get_parent(nodes[node]) != nodes[parent] || positions[parent] >= positions[node]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_incremental_order()
+{
+    World      world = make_world();
+    const auto nodes = add_tree(world);
+    CGX_CHECK(is_parent_first(world, nodes), "Incremental order placed a child before its parent.");
+}
+
+void test_batched_order()
+{
+    World world = make_world();
+    world.hierarchy_system->begin_batch();
+    const auto nodes = add_tree(world);
+    world.hierarchy_system->end_batch();
+    CGX_CHECK(is_parent_first(world, nodes), "Rebuilt order placed a child before its parent.");
+}
+
+// nodes their parent doesn't list are placed below that parent, even if it's added (or reached by a rebuild)
+// after them
+void test_unlisted_chain()
+{
+    for (const bool batched : {true, false}) {
+        World world = make_world();
+
+        // (added in entity order: the child before its parent, the parent before the root)
+        const auto nodes  = world.ecs_manager->acquire_entities(3);
+        const auto child  = nodes[0];
+        const auto parent = nodes[1];
+        const auto root   = nodes[2];
+
+        if (batched) {
+            world.hierarchy_system->begin_batch();
+        }
+        world.ecs_manager->add_component(child, component::Hierarchy{.parent = parent});
+        world.ecs_manager->add_component(parent, component::Hierarchy{.parent = root});
+        world.ecs_manager->add_component(root, component::Hierarchy{});
+        if (batched) {
+            world.hierarchy_system->end_batch();
+        }
+
+        const auto& order = world.hierarchy_system->get_order();
+        CGX_CHECK(order.size() == 3 && order[0] == root && world.hierarchy_system->get_parent(parent) == root
+                  && world.hierarchy_system->get_parent(child) == parent, "Unlisted child left a root.");
+    }
+}
+}
+}
+
+int main()
+{
+    return cgx::test::run_tests({
+        {"hierarchy/incremental_order", cgx::test::test_incremental_order},
+        {"hierarchy/batched_order", cgx::test::test_batched_order},
+        {"hierarchy/unlisted_chain", cgx::test::test_unlisted_chain},
+    });
+}
@@ -0,0 +1,126 @@
+// Copyright © 2024 Jacob Curlin
+
+// Tests the ecs manager's structural changes (component add / remove, entity release, command buffer flushes)
+// & the system memberships they update.
+
+#include "test.h"
+
+#include "ecs/command_buffer.h"
+#include "ecs/ecs_manager.h"
+#include "ecs/system.h"
+
+#include <memory>
+
+namespace cgx::test
+{
+namespace
+{
+struct Position
+{
+    float x, y, z;
+};
+
+struct Velocity
+{
+    float x, y, z;
+};
+
+struct Tag
+{
+    std::uint32_t value;
+};
+
+// matches every entity holding a position & a velocity; only its membership is checked
+class MembershipSystem final : public ecs::System
+{
+public:
+    explicit MembershipSystem(ecs::ECSManager* ecs_manager)
+        : System(ecs_manager) {}
+
+    void frame_update(float) override {}
+    void fixed_update(float) override {}
+    void on_entity_added(ecs::Entity) override {}
+    void on_entity_removed(ecs::Entity) override {}
+};
+
+std::unique_ptr<ecs::ECSManager> make_world()
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<Position>();
+    ecs_manager->register_component<Velocity>();
+    ecs_manager->register_component<Tag>();
+    return ecs_manager;
+}
+
+// a component removed & its entity released in one command buffer batch must still leave the system
+void test_remove_then_release()
+{
+    const auto world  = make_world();
+    const auto system = register_system<MembershipSystem, Position, Velocity>(*world);
+
+    const ecs::Entity entity = world->acquire_entity();
+    world->add_components(entity, Position{}, Velocity{});
+
+    ecs::CommandBuffer commands(world.get());
+    commands.remove_component<Velocity>(entity);
+    commands.release_entity(entity);
+    commands.flush();
+
+    CGX_CHECK(!world->is_valid(entity) && system->m_entities.empty(), "Released entity left in a system.");
+}
+
+// entities already matching a system's signature when it's set join the system; tags (in no signature) leave
+// its membership alone
+void test_membership_observer()
+{
+    const auto world    = make_world();
+    const auto entities = world->acquire_entities(4);
+    world->add_components(entities, Position{}, Velocity{});
+
+    const auto system = register_system<MembershipSystem, Position, Velocity>(*world);
+    CGX_CHECK(system->m_entities.size() == entities.size(), "Matching entities didn't join a new system.");
+
+    world->add_component(entities[0], Tag{});
+    world->remove_component<Velocity>(entities[1]);
+    CGX_CHECK(system->m_entities.size() == entities.size() - 1 && system->m_entities.count(entities[0]) == 1
+              && system->m_entities.count(entities[1]) == 0, "System membership out of date.");
+}
+
+// a slot released at its last generation is retired, so no handle to it validates again until it's reclaimed
+// (only in a world without entities)
+void test_generation_retirement()
+{
+    const auto world = make_world();
+
+    const ecs::Entity first  = world->acquire_entity();
+    ecs::Entity       entity = first;
+    for (std::uint32_t generation = 0 ; generation < ecs::ENTITY_GENERATION_MASK ; ++generation) {
+        world->release_entity(entity);
+        entity = world->acquire_entity();
+    }
+    CGX_CHECK(ecs::get_entity_index(entity) == ecs::get_entity_index(first)
+              && ecs::get_entity_generation(entity) == ecs::ENTITY_GENERATION_MASK, "Released slot not reused.");
+
+    world->release_entity(entity);
+    const ecs::Entity next = world->acquire_entity();
+    CGX_CHECK(ecs::get_entity_index(next) != ecs::get_entity_index(first) && !world->is_valid(first)
+              && !world->is_valid(entity), "Slot reused past its last generation.");
+    CGX_CHECK(world->get_retired_entity_count() == 1, "Retired slot not counted.");
+
+    CGX_CHECK(!world->reclaim_retired_entities(), "Retired slots reclaimed while entities are live.");
+    world->release_entity(next);
+    CGX_CHECK(world->reclaim_retired_entities() && world->get_retired_entity_count() == 0,
+              "Retired slots not reclaimed in an empty world.");
+    CGX_CHECK(world->acquire_entity() == first, "Reclaimed slot not reused from its first generation.");
+}
+}
+}
+
+int main()
+{
+    return cgx::test::run_tests({
+        {"registry/remove_then_release", cgx::test::test_remove_then_release},
+        {"registry/membership_observer", cgx::test::test_membership_observer},
+        {"registry/generation_retirement", cgx::test::test_generation_retirement},
+    });
+}
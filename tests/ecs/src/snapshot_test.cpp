@@ -0,0 +1,239 @@
+// Copyright © 2024 Jacob Curlin
+
+// Tests world snapshots: a saved world loads back into a fresh one with the same entities, signatures &
+// component data (raw pages for trivially copyable components, a serializer for hierarchies; tags are registered
+// but never added, so their section is empty; retired slots stay retired), & truncated or inconsistent files fail
+// to load without changing the world they were loaded into.
+
+#include "test.h"
+
+#include "ecs/ecs_manager.h"
+#include "core/components/hierarchy.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <typeinfo>
+#include <vector>
+
+namespace cgx::test
+{
+namespace
+{
+constexpr std::size_t k_entity_count = 1'000;
+
+struct Position
+{
+    float x, y, z;
+};
+
+struct Tag
+{
+    std::uint32_t value;
+};
+
+std::filesystem::path get_path()
+{
+    return std::filesystem::temp_directory_path() / "cgx_snapshot_test.snapshot";
+}
+
+std::unique_ptr<ecs::ECSManager> make_world()
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<Position>();
+    ecs_manager->register_component<Tag>();
+    ecs_manager->register_component<component::Hierarchy>();
+    ecs_manager->set_component_serializer<component::Hierarchy>(component::get_hierarchy_serializer());
+    return ecs_manager;
+}
+
+// Every entity holds a position & every fourth one a hierarchy node (a chain over those entities). Every tenth
+// entity is released again, so the snapshot holds free slots.
+std::vector<ecs::Entity> populate(ecs::ECSManager& ecs_manager)
+{
+    auto entities = ecs_manager.acquire_entities(k_entity_count);
+    for (std::size_t i = 0 ; i < entities.size() ; ++i) {
+        ecs_manager.add_component(entities[i], Position{static_cast<float>(i), 1.0f, 2.0f});
+    }
+    for (std::size_t i = 0 ; i < entities.size() ; i += 4) {
+        component::Hierarchy hierarchy;
+        if (i >= 4) {
+            hierarchy.parent = entities[i - 4];
+        }
+        if (i + 4 < entities.size()) {
+            hierarchy.children.push_back(entities[i + 4]);
+        }
+        ecs_manager.add_component(entities[i], std::move(hierarchy));
+    }
+    for (std::size_t i = 5 ; i < entities.size() ; i += 10) {
+        ecs_manager.release_entity(entities[i]);
+    }
+    return entities;
+}
+
+std::vector<char> read_file(const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::filesystem::path& path, const char* data, const std::size_t size)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(data, static_cast<std::streamsize>(size));
+}
+
+// loading 'data' must fail & leave a fresh world empty (& usable)
+bool is_rejected(const char* data, const std::size_t size)
+{
+    write_file(get_path(), data, size);
+
+    const auto world     = make_world();
+    const bool loaded    = world->load_snapshot(get_path());
+    const auto entity    = world->acquire_entity();
+    const bool untouched = ecs::get_entity_index(entity) == 0 && world->is_valid(entity);
+    return !loaded && untouched;
+}
+
+template<typename T>
+void write_component_header(ecs::SnapshotWriter& writer, const bool raw, const std::vector<ecs::Entity>& entities)
+{
+    writer.write_string(typeid(T).name());
+    writer.write(static_cast<std::uint32_t>(sizeof(T)));
+    writer.write(static_cast<std::uint8_t>(raw));
+    writer.write_vector(entities);
+}
+
+// a snapshot of one live entity (index 0, holding a position) whose position section lists 'position_owner'
+std::vector<std::byte> make_snapshot(const ecs::Entity position_owner)
+{
+    ecs::SnapshotWriter writer;
+    writer.write(std::uint32_t{0x53584743});
+    writer.write(std::uint32_t{1});
+
+    const std::size_t entity_section = writer.begin_section();
+    writer.write_vector(std::vector<ecs::Entity>{ecs::make_entity(0, 0)});
+    writer.write_vector(std::vector<std::uint32_t>{1u << 0});
+    writer.write(ecs::ENTITY_INDEX_MASK); // (no free slots)
+    writer.write(std::uint32_t{1});
+    writer.end_section(entity_section);
+
+    const std::size_t component_section = writer.begin_section();
+    writer.write(std::uint32_t{3});
+
+    std::size_t section = writer.begin_section();
+    write_component_header<Position>(writer, true, {position_owner});
+    writer.write(Position{1.0f, 2.0f, 3.0f});
+    writer.end_section(section);
+
+    section = writer.begin_section();
+    write_component_header<Tag>(writer, true, {});
+    writer.end_section(section);
+
+    section = writer.begin_section();
+    write_component_header<component::Hierarchy>(writer, false, {});
+    writer.end_section(section);
+
+    writer.end_section(component_section);
+    return writer.get_buffer();
+}
+
+void test_round_trip()
+{
+    const auto saved    = make_world();
+    const auto entities = populate(*saved);
+    CGX_CHECK(saved->save_snapshot(get_path()), "Saving snapshot failed.");
+
+    const auto loaded = make_world();
+    CGX_CHECK(loaded->load_snapshot(get_path()), "Loading snapshot failed.");
+
+    for (const auto entity : entities) {
+        CGX_CHECK(saved->is_valid(entity) == loaded->is_valid(entity), "Snapshot changed which entities are live.");
+        if (!saved->is_valid(entity) || !loaded->is_valid(entity)) {
+            continue;
+        }
+
+        const bool same_signature = saved->has_component<Position>(entity) == loaded->has_component<Position>(entity)
+                                    && !loaded->has_component<Tag>(entity)
+                                    && saved->has_component<component::Hierarchy>(entity)
+                                       == loaded->has_component<component::Hierarchy>(entity);
+        CGX_CHECK(same_signature, "Snapshot changed an entity's signature.");
+
+        CGX_CHECK(std::memcmp(&saved->get_component<Position>(entity), &loaded->get_component<Position>(entity),
+                              sizeof(Position)) == 0, "Snapshot changed a position.");
+        if (saved->has_component<component::Hierarchy>(entity) && loaded->has_component<component::Hierarchy>(entity)) {
+            const auto& a = saved->get_component<component::Hierarchy>(entity);
+            const auto& b = loaded->get_component<component::Hierarchy>(entity);
+            CGX_CHECK(a.parent == b.parent && a.children == b.children && a.siblings == b.siblings,
+                      "Snapshot changed a hierarchy.");
+        }
+    }
+
+    // released slots are reused as they would have been in the saved world
+    CGX_CHECK(saved->acquire_entity() == loaded->acquire_entity(), "Snapshot changed the free-list.");
+    std::filesystem::remove(get_path());
+}
+
+// slots retired at their last generation stay retired in the loaded world
+void test_retired_slot()
+{
+    const auto        saved   = make_world();
+    const ecs::Entity retired = saved->acquire_entity();
+    ecs::Entity       entity  = retired;
+    for (std::uint32_t generation = 0 ; generation <= ecs::ENTITY_GENERATION_MASK ; ++generation) {
+        saved->release_entity(entity);
+        entity = generation < ecs::ENTITY_GENERATION_MASK ? saved->acquire_entity() : ecs::NULL_ENTITY;
+    }
+    CGX_CHECK(saved->save_snapshot(get_path()), "Saving snapshot failed.");
+
+    const auto loaded = make_world();
+    CGX_CHECK(loaded->load_snapshot(get_path()), "Snapshot holding a retired slot didn't load.");
+    CGX_CHECK(loaded->get_retired_entity_count() == 1, "Loaded retired slot not counted.");
+    CGX_CHECK(ecs::get_entity_index(loaded->acquire_entity()) != ecs::get_entity_index(retired),
+              "Retired slot reused after loading.");
+    std::filesystem::remove(get_path());
+}
+
+// every proper prefix of a valid snapshot is rejected
+void test_truncated()
+{
+    const auto saved = make_world();
+    populate(*saved);
+    CGX_CHECK(saved->save_snapshot(get_path()), "Saving snapshot failed.");
+
+    const auto bytes = read_file(get_path());
+    for (std::size_t size = 0 ; size < bytes.size() ; size += 1 + size / 64) {
+        CGX_CHECK(is_rejected(bytes.data(), size), "Truncated snapshot loaded.");
+    }
+    std::filesystem::remove(get_path());
+}
+
+// component sections must list exactly the live entities whose signature holds their type
+void test_inconsistent()
+{
+    const auto valid = make_snapshot(ecs::make_entity(0, 0));
+    write_file(get_path(), reinterpret_cast<const char*>(valid.data()), valid.size());
+    const auto world = make_world();
+    CGX_CHECK(world->load_snapshot(get_path()), "Hand-written snapshot didn't load.");
+
+    for (const ecs::Entity owner : {ecs::make_entity(5'000, 0), ecs::make_entity(0, 1), ecs::NULL_ENTITY}) {
+        const auto bytes = make_snapshot(owner);
+        CGX_CHECK(is_rejected(reinterpret_cast<const char*>(bytes.data()), bytes.size()),
+                  "Snapshot listing a component of a dead or out-of-range entity loaded.");
+    }
+    std::filesystem::remove(get_path());
+}
+}
+}
+
+int main()
+{
+    return cgx::test::run_tests({
+        {"snapshot/round_trip", cgx::test::test_round_trip},
+        {"snapshot/retired_slot", cgx::test::test_retired_slot},
+        {"snapshot/truncated", cgx::test::test_truncated},
+        {"snapshot/inconsistent", cgx::test::test_inconsistent},
+    });
+}
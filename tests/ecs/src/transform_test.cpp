@@ -0,0 +1,148 @@
+// Copyright © 2024 Jacob Curlin
+
+// Tests world matrix propagation: the flattened transform table on its own (rows recomputed only below changed
+// ones), the euler angle convention of edited rotations, & the transform system keeping world matrices of a
+// hierarchy up to date as transforms change.
+
+#include "test.h"
+
+#include "core/systems/hierarchy_system.h"
+#include "core/systems/transform_system.h"
+#include "core/transform_table.h"
+#include "ecs/ecs_manager.h"
+#include "core/components/hierarchy.h"
+#include "core/components/transform.h"
+
+#include <glm/glm.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace cgx::test
+{
+namespace
+{
+constexpr float k_fixed_dt = 1.0f / 60.0f;
+
+glm::mat4 make_translation(const glm::vec3& translation)
+{
+    return glm::translate(glm::mat4(1.0f), translation);
+}
+
+glm::vec3 get_translation(const glm::mat4& matrix)
+{
+    return glm::vec3(matrix[3].x, matrix[3].y, matrix[3].z);
+}
+
+bool is_near(const glm::mat4& a, const glm::mat4& b)
+{
+    for (int column = 0 ; column < 4 ; ++column) {
+        for (int row = 0 ; row < 4 ; ++row) {
+            if (std::abs(a[column][row] - b[column][row]) > 1e-5f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// a chain of rows (root, child, grandchild) & a second root; only rows below a changed one are recomputed
+void test_table_propagation()
+{
+    core::TransformTable table;
+    const auto root       = table.push(ecs::make_entity(0, 0), core::TransformTable::k_no_parent,
+                                       make_translation(glm::vec3(1.0f, 0.0f, 0.0f)), 0);
+    const auto child      = table.push(ecs::make_entity(1, 0), root, make_translation(glm::vec3(0.0f, 2.0f, 0.0f)), 1);
+    const auto grandchild = table.push(ecs::make_entity(2, 0), child, make_translation(glm::vec3(0.0f, 0.0f, 3.0f)), 2);
+    const auto other      = table.push(ecs::make_entity(3, 0), core::TransformTable::k_no_parent, glm::mat4(1.0f), 3);
+
+    CGX_CHECK(table.propagate().size() == 4, "Pushed rows not all computed.");
+    CGX_CHECK(get_translation(table.get_world_matrix(grandchild)) == glm::vec3(1.0f, 2.0f, 3.0f),
+              "World matrix doesn't compose its ancestors'.");
+
+    table.set_local_matrix(child, make_translation(glm::vec3(0.0f, 4.0f, 0.0f)));
+    const std::vector<std::uint32_t> updated = table.propagate();
+    CGX_CHECK((updated == std::vector<std::uint32_t>{child, grandchild}), "Rows outside the changed subtree recomputed.");
+    CGX_CHECK(get_translation(table.get_world_matrix(grandchild)) == glm::vec3(1.0f, 4.0f, 3.0f),
+              "Descendant of a changed row not recomputed.");
+    CGX_CHECK(table.propagate().empty(), "Unchanged rows recomputed.");
+
+    // (the scan starts at the lowest dirty row; its parent's world matrix is still used)
+    table.set_local_matrix(grandchild, make_translation(glm::vec3(0.0f, 0.0f, 5.0f)));
+    CGX_CHECK((table.propagate() == std::vector<std::uint32_t>{grandchild})
+              && get_translation(table.get_world_matrix(grandchild)) == glm::vec3(1.0f, 4.0f, 5.0f),
+              "Changed leaf row not recomputed alone.");
+
+    // (an entity without a row isn't mistaken for a root)
+    CGX_CHECK(table.find_row(ecs::make_entity(4, 0)) == core::TransformTable::k_no_row
+              && core::TransformTable::k_no_row != core::TransformTable::k_no_parent
+              && table.find_row(ecs::make_entity(3, 1)) == core::TransformTable::k_no_row
+              && table.find_row(ecs::make_entity(3, 0)) == other, "Row lookup returned a wrong row.");
+}
+
+// euler angles compose as rotate(x) * rotate(y) * rotate(z) & read back as set
+void test_euler_angles()
+{
+    const glm::vec3 degrees(10.0f, 20.0f, 30.0f);
+    const glm::vec3 radians = glm::radians(degrees);
+
+    glm::mat4 expected = glm::rotate(glm::mat4(1.0f), radians.x, glm::vec3(1.0f, 0.0f, 0.0f));
+    expected           = glm::rotate(expected, radians.y, glm::vec3(0.0f, 1.0f, 0.0f));
+    expected           = glm::rotate(expected, radians.z, glm::vec3(0.0f, 0.0f, 1.0f));
+
+    component::Transform transform{};
+    transform.set_euler_angles(degrees);
+    CGX_CHECK(is_near(glm::mat4_cast(transform.rotation), expected), "Euler angles composed in another order.");
+
+    const glm::vec3 read = transform.get_euler_angles();
+    CGX_CHECK(std::abs(read.x - degrees.x) < 1e-3f && std::abs(read.y - degrees.y) < 1e-3f
+              && std::abs(read.z - degrees.z) < 1e-3f, "Euler angles didn't read back as set.");
+}
+
+// world matrices follow changes of an ancestor's transform, including for children listed by no parent
+void test_system_world_matrices()
+{
+    auto ecs_manager = make_ecs_manager();
+    ecs_manager->register_component<component::Transform>();
+    ecs_manager->register_component<component::Hierarchy>();
+
+    const auto hierarchy_system = register_system<core::HierarchySystem, component::Hierarchy>(*ecs_manager);
+    register_system<core::TransformSystem, component::Transform>(*ecs_manager)->set_hierarchy_system(
+        hierarchy_system.get());
+
+    // (the grandchild is added first & its parent doesn't list it)
+    const auto entities   = ecs_manager->acquire_entities(3);
+    const auto grandchild = entities[0];
+    const auto child      = entities[1];
+    const auto root       = entities[2];
+
+    component::Transform transform{};
+    transform.translation = glm::vec3(1.0f, 0.0f, 0.0f);
+    ecs_manager->add_components(entities, transform);
+    ecs_manager->add_component(grandchild, component::Hierarchy{.parent = child});
+    ecs_manager->add_component(child, component::Hierarchy{.parent = root});
+    ecs_manager->add_component(root, component::Hierarchy{.children = {child}});
+
+    ecs_manager->fixed_update(k_fixed_dt);
+    CGX_CHECK(get_translation(ecs_manager->get_component<component::Transform>(grandchild).world_matrix)
+              == glm::vec3(3.0f, 0.0f, 0.0f), "World matrix doesn't compose its ancestors'.");
+
+    ecs_manager->get_component<component::Transform>(root).translation = glm::vec3(5.0f, 0.0f, 0.0f);
+    ecs_manager->mark_changed<component::Transform>(root);
+    ecs_manager->fixed_update(k_fixed_dt);
+    CGX_CHECK(get_translation(ecs_manager->get_component<component::Transform>(grandchild).world_matrix)
+              == glm::vec3(7.0f, 0.0f, 0.0f), "Descendant of a changed transform not recomputed.");
+}
+}
+}
+
+int main()
+{
+    return cgx::test::run_tests({
+        {"transform/table_propagation", cgx::test::test_table_propagation},
+        {"transform/euler_angles", cgx::test::test_euler_angles},
+        {"transform/system_world_matrices", cgx::test::test_system_world_matrices},
+    });
+}